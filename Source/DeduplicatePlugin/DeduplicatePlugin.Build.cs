@@ -71,7 +71,8 @@ public class DeduplicatePlugin : ModuleRules
 				"Slate",
                 "UMG",
 				"UnrealEd",
-                "SourceControl"
+                "SourceControl",
+				"ImageCore"
             }
 			);
 		
@@ -42,6 +42,7 @@ void UDeduplicateObject::Load(const TArray<FAssetData>& AssetsToAnalyze)
     if (Paths.Num() == 0)
     {
         OnLoadingAssetsCompleted.Broadcast();
+        return;
     }
 
 
@@ -85,9 +86,73 @@ void UDeduplicateObject::FindDuplicates(const TArray<FAssetData>& AssetsToAnalyz
 	CalculateComplexity(FilteredAssets);
 
 	if (ShouldLoadAssets())
+	{
+		TArray<FAssetData> AssetsToLoad;
+		AssetsToLoad.Reserve(FilteredAssets.Num());
+		for (const FAssetData& Asset : FilteredAssets)
+		{
+			if (!IsAssetFeatureCached(Asset))
+			{
+				AssetsToLoad.Add(Asset);
+			}
+		}
+
+		OnLoadingAssetsCompleted.AddUObject(this, &UDeduplicateObject::Iternal_StartFindDeduplicatesAfterLoad);
+		Load(AssetsToLoad);
+	}
+	else
+	{
+		Iternal_StartFindDeduplicatesAfterLoad();
+	}
+}
+
+void UDeduplicateObject::FindDuplicatesInGroups(const TArray<TArray<FAssetData>>& AssetGroups)
+{
+	bBatchExecution = true;
+	BatchAssetGroups.Reset();
+	BatchComplexities.Reset();
+	BatchProgressOffset = 0.0f;
+
+	float TotalComplexity = 0.0f;
+	TSet<FSoftObjectPath> UniqueAssets;
+	TArray<FAssetData> AssetsToLoad;
+	const bool bShouldLoadAssets = ShouldLoadAssets();
+
+	for (const TArray<FAssetData>& AssetGroup : AssetGroups)
+	{
+		TArray<FAssetData> FilteredAssets;
+		FilterAssetsByIncludeExclude(AssetGroup, FilteredAssets);
+		if (FilteredAssets.Num() < 2)
+		{
+			continue;
+		}
+
+		const float Complexity = CalculateComplexity(FilteredAssets);
+		TotalComplexity += Complexity;
+		BatchComplexities.Add(Complexity);
+
+		if (bShouldLoadAssets)
+		{
+			for (const FAssetData& Asset : FilteredAssets)
+			{
+				bool bAlreadyAdded = false;
+				UniqueAssets.Add(Asset.GetSoftObjectPath(), &bAlreadyAdded);
+				if (!bAlreadyAdded && !IsAssetFeatureCached(Asset))
+				{
+					AssetsToLoad.Add(Asset);
+				}
+			}
+		}
+
+		BatchAssetGroups.Add(MoveTemp(FilteredAssets));
+	}
+
+	AlgorithmComplexity = TotalComplexity;
+
+	if (bShouldLoadAssets)
 	{
 		OnLoadingAssetsCompleted.AddUObject(this, &UDeduplicateObject::Iternal_StartFindDeduplicatesAfterLoad);
-		Load(FilteredAssets);
+		Load(AssetsToLoad);
 	}
 	else
 	{
@@ -106,11 +171,44 @@ void UDeduplicateObject::Iternal_StartFindDeduplicatesAfterLoad()
 		return;
 	}
 
-	TArray<FDuplicateGroup> Result = Internal_FindDuplicates(DeduplicationAssets);
-    for (FDuplicateGroup& DuplicateGroupRef : Result)
-    {
-        DuplicateGroupRef.ConfidenceScore = DuplicateGroupRef.ConfidenceScore * Weight;
-    }
+	auto FinalizeGroups = [this](TArray<FDuplicateGroup>& Groups)
+		{
+			for (FDuplicateGroup& DuplicateGroupRef : Groups)
+			{
+				DuplicateGroupRef.ConfidenceScore = DuplicateGroupRef.ConfidenceScore * Weight;
+			}
+		};
+
+	TArray<FDuplicateGroup> Result;
+	if (bBatchExecution)
+	{
+		const float TotalComplexity = AlgorithmComplexity;
+		for (int32 SubJobIndex = 0; SubJobIndex < BatchAssetGroups.Num(); ++SubJobIndex)
+		{
+			if (ShouldStop())
+			{
+				break;
+			}
+
+			TArray<FDuplicateGroup> SubJobResult = Internal_FindDuplicates(BatchAssetGroups[SubJobIndex]);
+			FinalizeGroups(SubJobResult);
+			Result.Append(MoveTemp(SubJobResult));
+
+			// Sub-jobs recalculate the complexity of their own assets, the manager expects the complexity of the whole batch.
+			AlgorithmComplexity = TotalComplexity;
+			BatchProgressOffset += BatchComplexities[SubJobIndex];
+			SetProgress(0.0f);
+		}
+
+		BatchAssetGroups.Empty();
+		BatchComplexities.Empty();
+	}
+	else
+	{
+		Result = Internal_FindDuplicates(DeduplicationAssets);
+		DeduplicationAssets.Empty();
+		FinalizeGroups(Result);
+	}
 	OnDeduplicationCompleted.Broadcast(Result, this);
 }
 
@@ -125,6 +223,11 @@ bool UDeduplicateObject::ShouldLoadAssets_Implementation()
 	return false;
 }
 
+bool UDeduplicateObject::IsAssetFeatureCached(const FAssetData& Asset) const
+{
+	return false;
+}
+
 FDuplicateGroup UDeduplicateObject::CreateDuplicateGroup(const TArray<FAssetData>& NewAssets, float Score)
 {
 	GetAlgorithmName();
@@ -139,10 +242,26 @@ float UDeduplicateObject::CalculateConfidenceScore_Implementation(const TArray<F
 
 void UDeduplicateObject::SetProgress(float NewProgress)
 {
-    Progress = NewProgress;
+    Progress = BatchProgressOffset + NewProgress;
     OnDeduplicationProgressCompleted.Broadcast();
 }
 
+TArray<FDeduplicationSimilarPair> UDeduplicateObject::FindSimilarPairs(int32 NumItems, TFunctionRef<float(int32, int32)> Similarity, float ProgressScale)
+{
+    const int32 TileSize = OwnerManager != nullptr ? OwnerManager->PairwiseTileSize : 64;
+    const int32 MaxConcurrentTasks = OwnerManager != nullptr ? OwnerManager->MaxConcurrentTasks : 0;
+
+    return FDeduplicationTaskScheduler::FindSimilarPairs(NumItems, SimilarityThreshold, TileSize, MaxConcurrentTasks, Similarity,
+        [this]()
+        {
+            return ShouldStop();
+        },
+        [this, ProgressScale](float Fraction)
+        {
+            SetProgress(Fraction * ProgressScale);
+        });
+}
+
 float UDeduplicateObject::CalculateComplexity_Implementation(const TArray<FAssetData>& CheckAssets)
 {
     return 0.0f;
@@ -197,3 +316,30 @@ void UDeduplicateObject::FilterAssetsByIncludeExclude(const TArray<FAssetData>&
         }
     }
 }
+
+TArray<FDeduplicationSimilarPair> UDeduplicateObject::FilterSimilarPairs(TArrayView<const TPair<int32, int32>> CandidatePairs, TFunctionRef<float(int32, int32)> Similarity, float ProgressScale)
+{
+    const int32 TileSize = OwnerManager != nullptr ? OwnerManager->PairwiseTileSize : 64;
+    const int32 MaxConcurrentTasks = OwnerManager != nullptr ? OwnerManager->MaxConcurrentTasks : 0;
+
+    return FDeduplicationTaskScheduler::FilterSimilarPairs(CandidatePairs, SimilarityThreshold, TileSize, MaxConcurrentTasks, Similarity,
+        [this]()
+        {
+            return ShouldStop();
+        },
+        [this, ProgressScale](float Fraction)
+        {
+            SetProgress(Fraction * ProgressScale);
+        });
+}
+
+void UDeduplicateObject::ParallelForItems(int32 NumItems, TFunctionRef<void(int32)> Body) const
+{
+    const int32 MaxConcurrentTasks = OwnerManager != nullptr ? OwnerManager->MaxConcurrentTasks : 0;
+
+    FDeduplicationTaskScheduler::ParallelFor(NumItems, 16, MaxConcurrentTasks, Body,
+        [this]()
+        {
+            return ShouldStop();
+        });
+}
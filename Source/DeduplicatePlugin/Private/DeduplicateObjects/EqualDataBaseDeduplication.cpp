@@ -6,7 +6,49 @@
 
 
 #include "DeduplicateObjects/EqualDataBaseDeduplication.h"
+#include "Misc/ScopeLock.h"
 #include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "DeduplicationFingerprintCache.h"
+#include "DeduplicationPackageBytes.h"
+#include <atomic>
+
+namespace EqualDataBaseDeduplication
+{
+	static const int32 QGramLength = 4;
+	static const int32 QGramBucketBits = 10;
+
+	static void BuildSketch(TArrayView<const uint8> Data, TArray<uint32>& OutByteHistogram, TArray<uint32>& OutQGramCounts)
+	{
+		OutByteHistogram.Init(0, 256);
+		OutQGramCounts.Init(0, 1 << QGramBucketBits);
+
+		const uint8* Bytes = Data.GetData();
+		const int32 DataSize = Data.Num();
+		for (int32 Index = 0; Index < DataSize; ++Index)
+		{
+			++OutByteHistogram[Bytes[Index]];
+		}
+
+		// Q-grams are hashed into buckets. Summing the minimum per bucket over-counts shared q-grams, which keeps the bound safe.
+		for (int32 Index = 0; Index + QGramLength <= DataSize; ++Index)
+		{
+			uint32 QGram;
+			FMemory::Memcpy(&QGram, Bytes + Index, sizeof(QGram));
+			++OutQGramCounts[(QGram * 2654435761u) >> (32 - QGramBucketBits)];
+		}
+	}
+
+	static int64 SumOfMinimums(const TArray<uint32>& Counts1, const TArray<uint32>& Counts2)
+	{
+		int64 Sum = 0;
+		const int32 NumCounts = FMath::Min(Counts1.Num(), Counts2.Num());
+		for (int32 Index = 0; Index < NumCounts; ++Index)
+		{
+			Sum += FMath::Min(Counts1[Index], Counts2[Index]);
+		}
+		return Sum;
+	}
+}
 
 UEqualBaseDataDeduplication::UEqualBaseDataDeduplication()
 {
@@ -28,39 +70,146 @@ TArray<FDuplicateGroup> UEqualBaseDataDeduplication::Internal_FindDuplicates_Imp
 
 	CalculateComplexity(AssetsToAnalyze);
 
-	for (int32 i = 0; i < SupportedAssets.Num(); i++)
+	// Serialized bytes are expensive to rebuild, so they are spilled to disk; package bytes are simply read again.
+	AssetByteStore = MakeShared<FDeduplicationAssetByteStore, ESPMode::ThreadSafe>(static_cast<int64>(AssetBytesMemoryBudgetMB) * 1024 * 1024, ShouldUseSerialization, MaxLiveMappedFiles);
+
+	AssetSamples.Reset();
+	AssetSamples.Reserve(SupportedAssets.Num());
+	for (const FAssetData& Asset : SupportedAssets)
 	{
 		if (ShouldStop())
 		{
 			break;
 		}
-		
-		TArray<FAssetData> CurrentGroup;
-		CurrentGroup.Add(SupportedAssets[i]);
 
-		for (int32 j = i + 1; j < SupportedAssets.Num(); j++)
+		FAssetDataSample Sample;
+		ResolveAssetSample(Asset, Sample);
+		AssetSamples.Add(Asset.GetSoftObjectPath(), MoveTemp(Sample));
+	}
+
+	if (ShouldUseSerialization)
+	{
+		// UObject::Serialize is not safe to run on several threads at once, so every asset the pairwise comparison may need bytes of
+		// is serialized here, on the calling thread. Samples restored from the fingerprint cache skipped the load above.
+		// The store spills these bytes instead of dropping them and is sealed afterwards, so the workers below only ever read them back.
+		// Assets with features still need their bytes when they are compared with an asset without features.
+		bool bAnySampleWithoutFeatures = false;
+		for (const TPair<FSoftObjectPath, FAssetDataSample>& SamplePair : AssetSamples)
+		{
+			bAnySampleWithoutFeatures |= SamplePair.Value.bValid && !SamplePair.Value.bHasFeatures;
+		}
+
+		for (const FAssetData& Asset : SupportedAssets)
 		{
 			if (ShouldStop())
 			{
 				break;
 			}
-			
-			TArray<uint8> Data1, Data2;
 
-			if (LoadAssetData(SupportedAssets[i], Data1) && LoadAssetData(SupportedAssets[j], Data2))
+			const FAssetDataSample* Sample = AssetSamples.Find(Asset.GetSoftObjectPath());
+			if (Sample != nullptr && Sample->bValid && (!Sample->bHasFeatures || bAnySampleWithoutFeatures) && Sample->Digest.Size > 0)
 			{
-				float Similarity = CalculateSimilarity(Data1, Data2);
+				GetAssetBytes(Asset);
+			}
+		}
+		AssetByteStore->Seal();
+	}
+
+	TArray<const FAssetDataSample*> SamplesByIndex;
+	SamplesByIndex.Reserve(SupportedAssets.Num());
+	for (const FAssetData& Asset : SupportedAssets)
+	{
+		SamplesByIndex.Add(AssetSamples.Find(Asset.GetSoftObjectPath()));
+	}
+
+	std::atomic<int64> PrefilterCounts[static_cast<int32>(EPrefilterTier::Num)] = {};
+	const bool bPrefilter = ShouldBuildSketches();
+
+	auto PairSimilarity = [this, &SupportedAssets, &SamplesByIndex, &PrefilterCounts, bPrefilter](int32 IndexA, int32 IndexB)
+		{
+			const FAssetDataSample* Sample1 = SamplesByIndex[IndexA];
+			const FAssetDataSample* Sample2 = SamplesByIndex[IndexB];
+			if (Sample1 == nullptr || Sample2 == nullptr)
+			{
+				return -1.0f;
+			}
 
-				if (Similarity >= SimilarityThreshold)
+			if (bPrefilter)
+			{
+				const EPrefilterTier Tier = GetPrefilterRejectTier(*Sample1, *Sample2);
+				PrefilterCounts[static_cast<int32>(Tier)].fetch_add(1, std::memory_order_relaxed);
+				if (Tier != EPrefilterTier::Passed)
 				{
-					CurrentGroup.Add(SupportedAssets[j]);
-					SupportedAssets.RemoveAtSwap(j);
-					j--;
+					return 0.0f;
 				}
 			}
+
+			float Similarity = 0.0f;
+			return TryCalculateAssetSimilarity(SupportedAssets[IndexA], *Sample1, SupportedAssets[IndexB], *Sample2, Similarity) ? Similarity : -1.0f;
+		};
+
+	TArray<FDeduplicationSimilarPair> SimilarPairs;
+	TArray<TPair<int32, int32>> CandidatePairs;
+	if (GenerateCandidatePairs(SamplesByIndex, CandidatePairs))
+	{
+		SimilarPairs = FilterSimilarPairs(CandidatePairs, PairSimilarity, SupportedAssets.Num());
+	}
+	else
+	{
+		SimilarPairs = FindSimilarPairs(SupportedAssets.Num(), PairSimilarity, SupportedAssets.Num());
+	}
+
+	if (bPrefilter)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s prefilter: %lld pairs compared, rejected %lld by length, %lld by byte histogram, %lld by q-grams"),
+			*GetAlgorithmName_Implementation(),
+			PrefilterCounts[static_cast<int32>(EPrefilterTier::Passed)].load(),
+			PrefilterCounts[static_cast<int32>(EPrefilterTier::Length)].load(),
+			PrefilterCounts[static_cast<int32>(EPrefilterTier::ByteHistogram)].load(),
+			PrefilterCounts[static_cast<int32>(EPrefilterTier::QGram)].load());
+	}
+
+	TSet<uint64> SimilarPairKeys;
+	SimilarPairKeys.Reserve(SimilarPairs.Num());
+	for (const FDeduplicationSimilarPair& Pair : SimilarPairs)
+	{
+		SimilarPairKeys.Add((static_cast<uint64>(Pair.IndexA) << 32) | static_cast<uint32>(Pair.IndexB));
+	}
+
+	auto IsSimilarPair = [&SimilarPairKeys](int32 IndexA, int32 IndexB)
+		{
+			const uint32 Low = static_cast<uint32>(FMath::Min(IndexA, IndexB));
+			const uint32 High = static_cast<uint32>(FMath::Max(IndexA, IndexB));
+			return SimilarPairKeys.Contains((static_cast<uint64>(Low) << 32) | High);
+		};
+
+	// Greedy grouping over the precomputed pairs, in the same order as when the pairs were compared inline.
+	TArray<int32> RemainingAssets;
+	RemainingAssets.Reserve(SupportedAssets.Num());
+	for (int32 Index = 0; Index < SupportedAssets.Num(); ++Index)
+	{
+		RemainingAssets.Add(Index);
+	}
+
+	for (int32 i = 0; i < RemainingAssets.Num(); i++)
+	{
+		if (ShouldStop())
+		{
+			break;
 		}
+		
+		TArray<FAssetData> CurrentGroup;
+		CurrentGroup.Add(SupportedAssets[RemainingAssets[i]]);
 
-		SetProgress(i);
+		for (int32 j = i + 1; j < RemainingAssets.Num(); j++)
+		{
+			if (IsSimilarPair(RemainingAssets[i], RemainingAssets[j]))
+			{
+				CurrentGroup.Add(SupportedAssets[RemainingAssets[j]]);
+				RemainingAssets.RemoveAtSwap(j);
+				j--;
+			}
+		}
 
 		if (CurrentGroup.Num() > 1)
 		{
@@ -71,6 +220,8 @@ TArray<FDuplicateGroup> UEqualBaseDataDeduplication::Internal_FindDuplicates_Imp
 
 	}
 
+	AssetByteStore.Reset();
+
 	return DuplicateGroups;
 }
 
@@ -90,6 +241,20 @@ float UEqualBaseDataDeduplication::CalculateConfidenceScore_Implementation(const
 	float TotalSimilarity = 0.0f;
 	int32 ComparisonCount = 0;
 
+	TArray<FAssetDataSample> Samples;
+	Samples.SetNum(Assets.Num());
+	for (int32 i = 0; i < Assets.Num(); i++)
+	{
+		if (const FAssetDataSample* ResolvedSample = AssetSamples.Find(Assets[i].GetSoftObjectPath()))
+		{
+			Samples[i] = *ResolvedSample;
+		}
+		else
+		{
+			ResolveAssetSample(Assets[i], Samples[i]);
+		}
+	}
+
 	for (int32 i = 0; i < Assets.Num(); i++)
 	{
 		if (ShouldStop())
@@ -104,10 +269,10 @@ float UEqualBaseDataDeduplication::CalculateConfidenceScore_Implementation(const
 				break;
 			}
 			
-			TArray<uint8> Data1, Data2;
-			if (LoadAssetData(Assets[i], Data1) && LoadAssetData(Assets[j], Data2))
+			float Similarity = 0.0f;
+			if (TryCalculateAssetSimilarity(Assets[i], Samples[i], Assets[j], Samples[j], Similarity))
 			{
-				TotalSimilarity += CalculateSimilarity(Data1, Data2);
+				TotalSimilarity += Similarity;
 				ComparisonCount++;
 			}
 		}
@@ -123,7 +288,7 @@ float UEqualBaseDataDeduplication::CalculateConfidenceScore_Implementation(const
 	return 0.0f;
 }
 
-float UEqualBaseDataDeduplication::CalculateSimilarity(const TArray<uint8>& Data1, const TArray<uint8>& Data2) const
+float UEqualBaseDataDeduplication::CalculateSimilarity(TArrayView<const uint8> Data1, TArrayView<const uint8> Data2) const
 {
 	if (Data1.Num() == 0 || Data2.Num() == 0)
 	{
@@ -144,31 +309,86 @@ bool UEqualBaseDataDeduplication::LoadAssetData(const FAssetData& Asset, TArray<
 		}
 
 		TArray<uint8> SerializedData;
-		FMemoryWriter MemoryWriter(SerializedData, /*bIsPersistent=*/ true);
-		FObjectAndNameAsStringProxyArchive ProxyArchive(MemoryWriter, /*bLoadIfFind=*/ false);
-		AssetObject->Serialize(ProxyArchive);
+		{
+			// Bytes are serialized up front on one thread before the byte store is sealed, this only guards callers outside of a run.
+			FScopeLock Lock(&SerializationLock);
+			FMemoryWriter MemoryWriter(SerializedData, /*bIsPersistent=*/ true);
+			FObjectAndNameAsStringProxyArchive ProxyArchive(MemoryWriter, /*bLoadIfFind=*/ false);
+			AssetObject->Serialize(ProxyArchive);
+		}
 
 		OutData = MoveTemp(SerializedData);
 		return true;
 	}
 
+	FString UAssetPath;
+	if (GetAssetPackageFilename(Asset, UAssetPath))
+	{
+		return FFileHelper::LoadFileToArray(OutData, *UAssetPath);
+	}
+
+	return false;
+}
+
+bool UEqualBaseDataDeduplication::GetAssetPackageFilename(const FAssetData& Asset, FString& OutFilename) const
+{
 	FString AssetPath = Asset.GetObjectPathString();
 	int Index;
 	AssetPath.FindLastChar(*TEXT("."), Index);
 	AssetPath = AssetPath.Left(Index);
 	FString PackagePath = FPackageName::LongPackageNameToFilename(AssetPath);
 
-	FString UAssetPath = PackagePath + TEXT(".uasset");
+	OutFilename = PackagePath + TEXT(".uasset");
+	return FPaths::FileExists(OutFilename);
+}
 
-	if (FPaths::FileExists(UAssetPath))
+FDeduplicationAssetBytes UEqualBaseDataDeduplication::LoadAssetBytes(const FAssetData& Asset) const
+{
+	if (!ShouldUseSerialization)
 	{
-		return FFileHelper::LoadFileToArray(OutData, *UAssetPath);
+		// Package files are mapped instead of copied to the heap, algorithms only ever read them.
+		FString UAssetPath;
+		if (!GetAssetPackageFilename(Asset, UAssetPath))
+		{
+			return nullptr;
+		}
+
+		FDeduplicationAssetBytes PackageBytes = FDeduplicationAssetBuffer::ReadFile(UAssetPath, bUseMemoryMappedReads);
+		if (!PackageBytes.IsValid() || !bCompareExportsOnly)
+		{
+			return PackageBytes;
+		}
+
+		// The header tables contain the path of the asset, only the exports say anything about its content.
+		if (bNormalizeNameIndices)
+		{
+			TArray<uint8> NormalizedExports;
+			if (FDeduplicationPackageBytes::ExtractNormalizedExports(PackageBytes->GetView(), NormalizedExports))
+			{
+				return MakeShared<FDeduplicationAssetBuffer, ESPMode::ThreadSafe>(MoveTemp(NormalizedExports));
+			}
+		}
+		else
+		{
+			int64 ExportOffset = 0;
+			int64 ExportSize = 0;
+			if (FDeduplicationPackageBytes::FindExportRegion(PackageBytes->GetView(), ExportOffset, ExportSize))
+			{
+				return MakeShared<FDeduplicationAssetBuffer, ESPMode::ThreadSafe>(PackageBytes, static_cast<int32>(ExportOffset), static_cast<int32>(ExportSize));
+			}
+		}
+		return PackageBytes;
 	}
 
-	return false;
+	TArray<uint8> Data;
+	if (!LoadAssetData(Asset, Data))
+	{
+		return nullptr;
+	}
+	return MakeShared<FDeduplicationAssetBuffer, ESPMode::ThreadSafe>(MoveTemp(Data));
 }
 
-float UEqualBaseDataDeduplication::CalculateBinarySimilarity(const TArray<uint8>& Data1, const TArray<uint8>& Data2) const
+float UEqualBaseDataDeduplication::CalculateBinarySimilarity(TArrayView<const uint8> Data1, TArrayView<const uint8> Data2) const
 {
 	return 0.0f;
 }
@@ -177,3 +397,229 @@ bool UEqualBaseDataDeduplication::ShouldLoadAssets_Implementation()
 {
 	return ShouldUseSerialization;
 }
+
+bool UEqualBaseDataDeduplication::IsAssetFeatureCached(const FAssetData& Asset) const
+{
+	if (!bUseFingerprintCache || GetAssetFeatureName().IsNone())
+	{
+		// Without compact features the raw bytes are still needed for every non-identical pair.
+		return false;
+	}
+
+	FDeduplicationFingerprintCache& Cache = FDeduplicationFingerprintCache::Get();
+	return Cache.HasFeature(Asset, GetCachedDigestName()) && Cache.HasFeature(Asset, GetCachedFeatureName());
+}
+
+FName UEqualBaseDataDeduplication::GetAssetFeatureName() const
+{
+	return NAME_None;
+}
+
+bool UEqualBaseDataDeduplication::BuildAssetFeatures(TArrayView<const uint8> Data, TArray<uint8>& OutFeatures) const
+{
+	return false;
+}
+
+float UEqualBaseDataDeduplication::CalculateFeatureSimilarity(const TArray<uint8>& Features1, const TArray<uint8>& Features2) const
+{
+	return 0.0f;
+}
+
+bool UEqualBaseDataDeduplication::SupportsAlignmentPrefilter() const
+{
+	return false;
+}
+
+bool UEqualBaseDataDeduplication::ShouldBuildSketches() const
+{
+	return bUseSimilarityPrefilter && SupportsAlignmentPrefilter();
+}
+
+UEqualBaseDataDeduplication::EPrefilterTier UEqualBaseDataDeduplication::GetPrefilterRejectTier(const FAssetDataSample& Sample1, const FAssetDataSample& Sample2) const
+{
+	if (!Sample1.bValid || !Sample2.bValid || Sample1.Digest.Size == 0 || Sample2.Digest.Size == 0)
+	{
+		return EPrefilterTier::Passed;
+	}
+
+	// Similarity = Matches / AlignmentLength with Matches <= MinLength and AlignmentLength >= MaxLength.
+	const int64 MinLength = FMath::Min(Sample1.Digest.Size, Sample2.Digest.Size);
+	const int64 MaxLength = FMath::Max(Sample1.Digest.Size, Sample2.Digest.Size);
+	if (static_cast<double>(MinLength) < SimilarityThreshold * static_cast<double>(MaxLength))
+	{
+		return EPrefilterTier::Length;
+	}
+
+	if (!Sample1.bHasSketch || !Sample2.bHasSketch)
+	{
+		return EPrefilterTier::Passed;
+	}
+
+	// Every match pairs two equal bytes, so there are at most sum(min(Count1[Byte], Count2[Byte])) matches.
+	const int64 MaxMatches = EqualDataBaseDeduplication::SumOfMinimums(Sample1.Sketch.ByteHistogram, Sample2.Sketch.ByteHistogram);
+	if (static_cast<double>(MaxMatches) < SimilarityThreshold * static_cast<double>(MaxLength))
+	{
+		return EPrefilterTier::ByteHistogram;
+	}
+
+	// Q-gram lemma: strings within edit distance K share at least MaxLength - Q + 1 - K * Q q-grams. Every non-matching column of the
+	// alignment is one edit, so AlignmentLength >= Matches + K and the similarity is at most MaxMatches / max(MaxLength, MaxMatches + K).
+	const int64 QGramLength = EqualDataBaseDeduplication::QGramLength;
+	const int64 SharedQGrams = EqualDataBaseDeduplication::SumOfMinimums(Sample1.Sketch.QGramCounts, Sample2.Sketch.QGramCounts);
+	const int64 MissingQGrams = MaxLength - QGramLength + 1 - SharedQGrams;
+	const int64 MinEdits = MissingQGrams > 0 ? (MissingQGrams + QGramLength - 1) / QGramLength : 0;
+	const int64 MinAlignmentLength = FMath::Max(MaxLength, MaxMatches + MinEdits);
+	if (static_cast<double>(MaxMatches) < SimilarityThreshold * static_cast<double>(MinAlignmentLength))
+	{
+		return EPrefilterTier::QGram;
+	}
+
+	return EPrefilterTier::Passed;
+}
+
+bool UEqualBaseDataDeduplication::GenerateCandidatePairs(TArrayView<const FAssetDataSample* const> Samples, TArray<TPair<int32, int32>>& OutCandidatePairs) const
+{
+	return false;
+}
+
+const TCHAR* UEqualBaseDataDeduplication::GetByteSourceName() const
+{
+	if (ShouldUseSerialization)
+	{
+		return TEXT("Serialized");
+	}
+	if (!bCompareExportsOnly)
+	{
+		return TEXT("Package");
+	}
+	// Versioned: earlier runs cached digests of exports cut at the bulk data offset, and of the heuristic name rewriting.
+	return bNormalizeNameIndices ? TEXT("PackageExportsNormalized.v2") : TEXT("PackageExports.v2");
+}
+
+FName UEqualBaseDataDeduplication::GetCachedDigestName() const
+{
+	return FName(*FString::Printf(TEXT("BaseData.Digest.%s"), GetByteSourceName()));
+}
+
+FName UEqualBaseDataDeduplication::GetCachedFeatureName() const
+{
+	const FName FeatureName = GetAssetFeatureName();
+	if (FeatureName.IsNone())
+	{
+		return NAME_None;
+	}
+	return FName(*FString::Printf(TEXT("%s.%s"), *FeatureName.ToString(), GetByteSourceName()));
+}
+
+FName UEqualBaseDataDeduplication::GetCachedSketchName() const
+{
+	return FName(*FString::Printf(TEXT("BaseData.Sketch.v1.%s"), GetByteSourceName()));
+}
+
+bool UEqualBaseDataDeduplication::ResolveAssetSample(const FAssetData& Asset, FAssetDataSample& OutSample) const
+{
+	OutSample = FAssetDataSample();
+	const bool bNeedsFeatures = !GetAssetFeatureName().IsNone();
+	const bool bNeedsSketch = ShouldBuildSketches();
+
+	if (bUseFingerprintCache)
+	{
+		FDeduplicationFingerprintCache& Cache = FDeduplicationFingerprintCache::Get();
+		const bool bDigestCached = Cache.FindFeature(Asset, GetCachedDigestName(), OutSample.Digest);
+		const bool bFeaturesCached = !bNeedsFeatures || Cache.FindFeature(Asset, GetCachedFeatureName(), OutSample.Features);
+		const bool bSketchCached = !bNeedsSketch || Cache.FindFeature(Asset, GetCachedSketchName(), OutSample.Sketch);
+		if (bDigestCached && bFeaturesCached && bSketchCached)
+		{
+			OutSample.bHasFeatures = bNeedsFeatures;
+			OutSample.bHasSketch = bNeedsSketch;
+			OutSample.bValid = true;
+			return true;
+		}
+		OutSample = FAssetDataSample();
+	}
+
+	// Algorithms with compact features do not need the bytes after this point, so they bypass the byte store.
+	FDeduplicationAssetBytes Data = bNeedsFeatures ? LoadAssetBytes(Asset) : GetAssetBytes(Asset);
+
+	if (!Data.IsValid())
+	{
+		return false;
+	}
+
+	OutSample.Digest.Hash = FIoHash::HashBuffer(Data->GetData(), Data->Num());
+	OutSample.Digest.Size = Data->Num();
+	OutSample.bHasFeatures = bNeedsFeatures && BuildAssetFeatures(Data->GetView(), OutSample.Features);
+	if (bNeedsSketch)
+	{
+		EqualDataBaseDeduplication::BuildSketch(Data->GetView(), OutSample.Sketch.ByteHistogram, OutSample.Sketch.QGramCounts);
+		OutSample.bHasSketch = true;
+	}
+	OutSample.bValid = true;
+
+	if (bUseFingerprintCache)
+	{
+		FDeduplicationFingerprintCache& Cache = FDeduplicationFingerprintCache::Get();
+		Cache.StoreFeature(Asset, GetCachedDigestName(), OutSample.Digest);
+		if (OutSample.bHasFeatures)
+		{
+			TArray<uint8> FeaturesCopy = OutSample.Features;
+			Cache.StoreFeature(Asset, GetCachedFeatureName(), MoveTemp(FeaturesCopy));
+		}
+		if (OutSample.bHasSketch)
+		{
+			Cache.StoreFeature(Asset, GetCachedSketchName(), OutSample.Sketch);
+		}
+	}
+
+	return true;
+}
+
+bool UEqualBaseDataDeduplication::TryCalculateAssetSimilarity(const FAssetData& Asset1, const FAssetDataSample& Sample1, const FAssetData& Asset2, const FAssetDataSample& Sample2, float& OutSimilarity) const
+{
+	OutSimilarity = 0.0f;
+	if (!Sample1.bValid || !Sample2.bValid)
+	{
+		return false;
+	}
+
+	if (Sample1.Digest.Size == 0 || Sample2.Digest.Size == 0)
+	{
+		return true;
+	}
+
+	// Identical bytes are a perfect match for every binary metric, no need to touch the data.
+	if (Sample1.Digest.Size == Sample2.Digest.Size && Sample1.Digest.Hash == Sample2.Digest.Hash)
+	{
+		OutSimilarity = 1.0f;
+		return true;
+	}
+
+	if (Sample1.bHasFeatures && Sample2.bHasFeatures)
+	{
+		OutSimilarity = FMath::Clamp(CalculateFeatureSimilarity(Sample1.Features, Sample2.Features), 0.0f, 1.0f);
+		return true;
+	}
+
+	FDeduplicationAssetBytes Data1 = GetAssetBytes(Asset1);
+	FDeduplicationAssetBytes Data2 = GetAssetBytes(Asset2);
+	if (Data1.IsValid() && Data2.IsValid())
+	{
+		OutSimilarity = CalculateSimilarity(Data1->GetView(), Data2->GetView());
+		return true;
+	}
+
+	return false;
+}
+
+FDeduplicationAssetBytes UEqualBaseDataDeduplication::GetAssetBytes(const FAssetData& Asset) const
+{
+	if (AssetByteStore.IsValid())
+	{
+		return AssetByteStore->GetAssetBytes(Asset, [this, &Asset]()
+			{
+				return LoadAssetBytes(Asset);
+			});
+	}
+
+	return LoadAssetBytes(Asset);
+}
@@ -6,47 +6,359 @@
 
 
 #include "DeduplicateObjects/EqualHashDataDeduplication.h"
+#include "Hash/CityHash.h"
 
-float UEqualHashDataDeduplication::CalculateBinarySimilarity(const TArray<uint8>& Data1, const TArray<uint8>& Data2) const
+namespace EqualHashDataDeduplication
 {
-	const int32 BlockSize = 64;
+	static const int32 BlockSize = 64;
 
-	auto ComputeBlockHashes = [&](const TArray<uint8>& Data) -> TSet<uint32>
+	// Random 64-bit values per byte for the Gear rolling hash, generated with SplitMix64 so they never change between runs.
+	struct FGearTable
+	{
+		uint64 Values[256];
+
+		FGearTable()
+		{
+			uint64 State = 0x9E3779B97F4A7C15ull;
+			for (uint64& Value : Values)
+			{
+				State += 0x9E3779B97F4A7C15ull;
+				uint64 Mixed = State;
+				Mixed = (Mixed ^ (Mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+				Mixed = (Mixed ^ (Mixed >> 27)) * 0x94D049BB133111EBull;
+				Value = Mixed ^ (Mixed >> 31);
+			}
+		}
+	};
+
+	static const FGearTable& GetGearTable()
+	{
+		static const FGearTable Table;
+		return Table;
+	}
+
+	// Gear shifts the hash left, so the highest bits cover the widest window, up to the oldest bytes still in it, and are the ones tested for a cut point.
+	static uint64 MakeCutMask(int32 NumBits)
+	{
+		NumBits = FMath::Clamp(NumBits, 1, 63);
+		return ~0ull << (64 - NumBits);
+	}
+
+	// FastCDC-style chunking: no cut before MinSize, a harder mask until AverageSize and an easier one after it, a forced cut at MaxSize.
+	static int32 FindChunkEnd(const uint8* Data, int32 DataSize, int32 MinSize, int32 AverageSize, int32 MaxSize)
+	{
+		if (DataSize <= MinSize)
+		{
+			return DataSize;
+		}
+
+		const FGearTable& Gear = GetGearTable();
+		const int32 AverageBits = FMath::FloorLog2(static_cast<uint32>(AverageSize));
+		const uint64 MaskSmall = MakeCutMask(AverageBits + 1);
+		const uint64 MaskLarge = MakeCutMask(AverageBits - 1);
+		const int32 NormalEnd = FMath::Min(AverageSize, DataSize);
+		const int32 End = FMath::Min(MaxSize, DataSize);
+
+		uint64 Hash = 0;
+		int32 Offset = MinSize;
+		for (; Offset < NormalEnd; ++Offset)
+		{
+			Hash = (Hash << 1) + Gear.Values[Data[Offset]];
+			if ((Hash & MaskSmall) == 0)
+			{
+				return Offset + 1;
+			}
+		}
+		for (; Offset < End; ++Offset)
 		{
-			TSet<uint32> HashSet;
-			const int32 DataSize = Data.Num();
+			Hash = (Hash << 1) + Gear.Values[Data[Offset]];
+			if ((Hash & MaskLarge) == 0)
+			{
+				return Offset + 1;
+			}
+		}
+		return End;
+	}
+
+	static void SortUnique(TArray<uint64>& Hashes)
+	{
+		Hashes.Sort();
+		int32 UniqueCount = 0;
+		for (int32 Index = 0; Index < Hashes.Num(); ++Index)
+		{
+			if (UniqueCount == 0 || Hashes[UniqueCount - 1] != Hashes[Index])
+			{
+				Hashes[UniqueCount++] = Hashes[Index];
+			}
+		}
+		Hashes.SetNum(UniqueCount);
+	}
+
+	static void ComputeSortedChunkHashes(TArrayView<const uint8> Data, const FEqualHashChunkingSettings& Settings, TArray<uint64>& OutHashes)
+	{
+		OutHashes.Reset();
+		const int32 DataSize = Data.Num();
+		const uint8* Bytes = Data.GetData();
+
+		if (!Settings.bContentDefined)
+		{
+			OutHashes.Reserve(FMath::DivideAndRoundUp(DataSize, BlockSize));
 			for (int32 Offset = 0; Offset < DataSize; Offset += BlockSize)
 			{
-				const int32 ChunkSize = FMath::Min(BlockSize, DataSize - Offset);
-				const uint32 HashValue = FCrc::MemCrc32(Data.GetData() + Offset, ChunkSize);
-				HashSet.Add(HashValue);
+				OutHashes.Add(CityHash64(reinterpret_cast<const char*>(Bytes + Offset), FMath::Min(BlockSize, DataSize - Offset)));
 			}
-			return HashSet;
-		};
+		}
+		else
+		{
+			OutHashes.Reserve(DataSize / Settings.AverageSize + 1);
+			for (int32 Offset = 0; Offset < DataSize;)
+			{
+				const int32 ChunkSize = FindChunkEnd(Bytes + Offset, DataSize - Offset, Settings.MinSize, Settings.AverageSize, Settings.MaxSize);
+				OutHashes.Add(CityHash64(reinterpret_cast<const char*>(Bytes + Offset), ChunkSize));
+				Offset += ChunkSize;
+			}
+		}
+
+		SortUnique(OutHashes);
+	}
+
+	static float CalculateJaccard(TArrayView<const uint64> HashSet1, TArrayView<const uint64> HashSet2)
+	{
+		if (HashSet1.Num() == 0 && HashSet2.Num() == 0)
+		{
+			return 1.0f;
+		}
+
+		int32 IntersectionCount = 0;
+		int32 Index1 = 0;
+		int32 Index2 = 0;
+		while (Index1 < HashSet1.Num() && Index2 < HashSet2.Num())
+		{
+			if (HashSet1[Index1] == HashSet2[Index2])
+			{
+				IntersectionCount++;
+				Index1++;
+				Index2++;
+			}
+			else if (HashSet1[Index1] < HashSet2[Index2])
+			{
+				Index1++;
+			}
+			else
+			{
+				Index2++;
+			}
+		}
+
+		const int32 UnionCount = HashSet1.Num() + HashSet2.Num() - IntersectionCount;
+		if (UnionCount == 0)
+		{
+			return 0.0f;
+		}
+
+		return (float)IntersectionCount / (float)UnionCount;
+	}
+
+	static TArrayView<const uint64> AsHashView(const TArray<uint8>& Features)
+	{
+		return TArrayView<const uint64>(reinterpret_cast<const uint64*>(Features.GetData()), Features.Num() / sizeof(uint64));
+	}
+
+	static uint64 MixHash(uint64 Value)
+	{
+		Value ^= Value >> 33;
+		Value *= 0xff51afd7ed558ccdull;
+		Value ^= Value >> 33;
+		Value *= 0xc4ceb9fe1a85ec53ull;
+		Value ^= Value >> 33;
+		return Value;
+	}
+
+	// The K hash functions are derived from two halves of one 64-bit hash (h1 + k * h2), which is enough for MinHash estimates.
+	static void ComputeMinHashSignature(TArrayView<const uint64> HashSet, int32 NumHashes, TArray<uint32>& OutSignature)
+	{
+		OutSignature.Init(MAX_uint32, NumHashes);
+		for (const uint64 ChunkHash : HashSet)
+		{
+			const uint64 Mixed = MixHash(ChunkHash);
+			const uint32 Hash1 = static_cast<uint32>(Mixed);
+			const uint32 Hash2 = static_cast<uint32>(Mixed >> 32) | 1u;
+			uint32 Value = Hash1;
+			for (int32 HashIndex = 0; HashIndex < NumHashes; ++HashIndex)
+			{
+				OutSignature[HashIndex] = FMath::Min(OutSignature[HashIndex], Value);
+				Value += Hash2;
+			}
+		}
+	}
+
+	// Two sets with Jaccard similarity J collide in at least one of B bands of R rows with probability 1 - (1 - J^R)^B.
+	static void ChooseBands(float Threshold, int32 NumHashes, int32& OutBands, int32& OutRows)
+	{
+		OutBands = NumHashes;
+		OutRows = 1;
+		for (int32 Rows = 1; Rows <= NumHashes; ++Rows)
+		{
+			if (NumHashes % Rows != 0)
+			{
+				continue;
+			}
+
+			const int32 Bands = NumHashes / Rows;
+			const double CandidateProbability = 1.0 - FMath::Pow(1.0 - FMath::Pow(static_cast<double>(Threshold), static_cast<double>(Rows)), static_cast<double>(Bands));
+			if (CandidateProbability >= 0.99)
+			{
+				OutBands = Bands;
+				OutRows = Rows;
+			}
+		}
+	}
+}
 
-	TSet<uint32> HashSet1 = ComputeBlockHashes(Data1);
-	TSet<uint32> HashSet2 = ComputeBlockHashes(Data2);
+FEqualHashChunkingSettings UEqualHashDataDeduplication::GetChunkingSettings() const
+{
+	FEqualHashChunkingSettings Settings;
+	Settings.bContentDefined = bUseContentDefinedChunking;
+	Settings.MinSize = FMath::Max(1, MinChunkSize);
+	Settings.AverageSize = static_cast<int32>(FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Max3(AverageChunkSize, Settings.MinSize * 2, 4))));
+	Settings.MaxSize = FMath::Max(Settings.AverageSize * 2, MaxChunkSize);
+	return Settings;
+}
+
+float UEqualHashDataDeduplication::CalculateBinarySimilarity(TArrayView<const uint8> Data1, TArrayView<const uint8> Data2) const
+{
+	const FEqualHashChunkingSettings Settings = GetChunkingSettings();
+	TArray<uint64> HashSet1;
+	TArray<uint64> HashSet2;
+	EqualHashDataDeduplication::ComputeSortedChunkHashes(Data1, Settings, HashSet1);
+	EqualHashDataDeduplication::ComputeSortedChunkHashes(Data2, Settings, HashSet2);
+
+	return EqualHashDataDeduplication::CalculateJaccard(HashSet1, HashSet2);
+}
+
+FName UEqualHashDataDeduplication::GetAssetFeatureName() const
+{
+	const FEqualHashChunkingSettings Settings = GetChunkingSettings();
+	if (!Settings.bContentDefined)
+	{
+		return FName(TEXT("EqualHash.Blocks64.v2"));
+	}
+	return FName(*FString::Printf(TEXT("EqualHash.Gear.v1.%d.%d.%d"), Settings.MinSize, Settings.AverageSize, Settings.MaxSize));
+}
+
+bool UEqualHashDataDeduplication::BuildAssetFeatures(TArrayView<const uint8> Data, TArray<uint8>& OutFeatures) const
+{
+	TArray<uint64> HashSet;
+	EqualHashDataDeduplication::ComputeSortedChunkHashes(Data, GetChunkingSettings(), HashSet);
+
+	OutFeatures.SetNumUninitialized(HashSet.Num() * sizeof(uint64));
+	FMemory::Memcpy(OutFeatures.GetData(), HashSet.GetData(), OutFeatures.Num());
+	return true;
+}
+
+float UEqualHashDataDeduplication::CalculateFeatureSimilarity(const TArray<uint8>& Features1, const TArray<uint8>& Features2) const
+{
+	return EqualHashDataDeduplication::CalculateJaccard(EqualHashDataDeduplication::AsHashView(Features1), EqualHashDataDeduplication::AsHashView(Features2));
+}
+
+bool UEqualHashDataDeduplication::GenerateCandidatePairs(TArrayView<const FAssetDataSample* const> Samples, TArray<TPair<int32, int32>>& OutCandidatePairs) const
+{
+	using namespace EqualHashDataDeduplication;
 
-	if (HashSet1.Num() == 0 && HashSet2.Num() == 0)
+	if (!bUseMinHashCandidates || SimilarityThreshold <= 0.0f)
 	{
-		return 1.0f;
+		return false;
 	}
 
-	int32 IntersectionCount = 0;
-	for (uint32 HashValue : HashSet1)
+	int32 NumBands = FMath::Max(1, MinHashBands);
+	int32 NumRows = FMath::Max(1, MinHashRowsPerBand);
+	if (bAutoTuneMinHashBands)
 	{
-		if (HashSet2.Contains(HashValue))
+		ChooseBands(FMath::Min(SimilarityThreshold, 1.0f), FMath::Clamp(MinHashSignatureSize, 1, 1024), NumBands, NumRows);
+	}
+	const int32 NumHashes = NumBands * NumRows;
+
+	const int32 NumSamples = Samples.Num();
+	TArray<TArray<uint32>> Signatures;
+	Signatures.SetNum(NumSamples);
+	ParallelForItems(NumSamples, [&Samples, &Signatures, NumHashes](int32 Index)
+		{
+			const FAssetDataSample* Sample = Samples[Index];
+			if (Sample != nullptr && Sample->bValid && Sample->bHasFeatures)
+			{
+				ComputeMinHashSignature(AsHashView(Sample->Features), NumHashes, Signatures[Index]);
+			}
+		});
+
+	if (ShouldStop())
+	{
+		return true;
+	}
+
+	TSet<uint64> CandidateKeys;
+	auto AddCandidate = [&CandidateKeys, &OutCandidatePairs](int32 IndexA, int32 IndexB)
 		{
-			IntersectionCount++;
+			const uint32 Low = static_cast<uint32>(FMath::Min(IndexA, IndexB));
+			const uint32 High = static_cast<uint32>(FMath::Max(IndexA, IndexB));
+			bool bAlreadyAdded = false;
+			CandidateKeys.Add((static_cast<uint64>(Low) << 32) | High, &bAlreadyAdded);
+			if (!bAlreadyAdded)
+			{
+				OutCandidatePairs.Emplace(Low, High);
+			}
+		};
+
+	TMap<uint32, TArray<int32>> Buckets;
+	for (int32 Band = 0; Band < NumBands; ++Band)
+	{
+		if (ShouldStop())
+		{
+			return true;
+		}
+
+		Buckets.Reset();
+		for (int32 Index = 0; Index < NumSamples; ++Index)
+		{
+			if (Signatures[Index].Num() == NumHashes)
+			{
+				const uint32 BucketKey = FCrc::MemCrc32(Signatures[Index].GetData() + Band * NumRows, NumRows * sizeof(uint32), Band);
+				Buckets.FindOrAdd(BucketKey).Add(Index);
+			}
+		}
+
+		for (const TPair<uint32, TArray<int32>>& Bucket : Buckets)
+		{
+			const TArray<int32>& Members = Bucket.Value;
+			for (int32 MemberA = 0; MemberA < Members.Num(); ++MemberA)
+			{
+				for (int32 MemberB = MemberA + 1; MemberB < Members.Num(); ++MemberB)
+				{
+					AddCandidate(Members[MemberA], Members[MemberB]);
+				}
+			}
 		}
 	}
 
-	const int32 UnionCount = HashSet1.Num() + HashSet2.Num() - IntersectionCount;
-	if (UnionCount == 0)
+	// Assets that have bytes but no chunk hashes can not be bucketed, so they are compared with everything.
+	for (int32 Index = 0; Index < NumSamples; ++Index)
 	{
-		return 0.0f;
+		const FAssetDataSample* Sample = Samples[Index];
+		if (Sample == nullptr || !Sample->bValid || Signatures[Index].Num() == NumHashes)
+		{
+			continue;
+		}
+
+		for (int32 OtherIndex = 0; OtherIndex < NumSamples; ++OtherIndex)
+		{
+			if (OtherIndex != Index && Samples[OtherIndex] != nullptr && Samples[OtherIndex]->bValid)
+			{
+				AddCandidate(Index, OtherIndex);
+			}
+		}
 	}
 
-	const float Similarity = (float)IntersectionCount / (float)UnionCount;
-	return Similarity;
-}
\ No newline at end of file
+	UE_LOG(LogTemp, Log, TEXT("%s: %d MinHash candidate pairs out of %lld (%d bands x %d rows)"), *GetAlgorithmName_Implementation(), OutCandidatePairs.Num(),
+		static_cast<int64>(NumSamples) * (NumSamples - 1) / 2, NumBands, NumRows);
+
+	return true;
+}
@@ -35,10 +35,113 @@ UEqualNameDeduplication::UEqualNameDeduplication()
 }
 
 
+namespace EqualNameDeduplication
+{
+	// Burkhard-Keller tree over normalized names with the Levenshtein metric. A child hangs off its parent under their distance, so a
+	// query with radius R only descends into children whose distance lies in [D - R, D + R], D being the query's distance to the parent.
+	class FNameBKTree
+	{
+	public:
+		// Adds Name as group GroupIndex. Returns the group of an equal name that is already in the tree, or GroupIndex.
+		int32 Add(const FString& Name, int32 GroupIndex)
+		{
+			if (Nodes.IsEmpty())
+			{
+				Nodes.Add({ Name, GroupIndex });
+				return GroupIndex;
+			}
+
+			int32 NodeIndex = 0;
+			while (true)
+			{
+				const int32 Distance = UDeduplicationFunctionLibrary::ComputeLevenshteinDistance(Name, Nodes[NodeIndex].Name);
+				if (Distance == 0)
+				{
+					return Nodes[NodeIndex].GroupIndex;
+				}
+
+				const TPair<int32, int32>* Child = Nodes[NodeIndex].Children.FindByPredicate([Distance](const TPair<int32, int32>& Edge) { return Edge.Key == Distance; });
+				if (Child == nullptr)
+				{
+					const int32 NewIndex = Nodes.Add({ Name, GroupIndex });
+					FNode& Parent = Nodes[NodeIndex];
+					Parent.Children.Emplace(Distance, NewIndex);
+					Parent.MaxChildDistance = FMath::Max(Parent.MaxChildDistance, Distance);
+					return GroupIndex;
+				}
+				NodeIndex = Child->Value;
+			}
+		}
+
+		// Smallest group index among names within Radius of Name whose distance passes Accepts, or INDEX_NONE.
+		template<typename AcceptsType>
+		int32 FindFirstGroup(const FString& Name, int32 Radius, AcceptsType&& Accepts) const
+		{
+			int32 BestGroup = INDEX_NONE;
+			if (Nodes.IsEmpty())
+			{
+				return BestGroup;
+			}
+
+			TArray<int32, TInlineAllocator<64>> Stack;
+			Stack.Add(0);
+			while (!Stack.IsEmpty())
+			{
+				const FNode& Node = Nodes[Stack.Pop(EAllowShrinking::No)];
+
+				// Beyond Radius + MaxChildDistance neither the node nor any child can be in range, so the distance is only needed up to there.
+				const int32 Bound = static_cast<int32>(FMath::Min<int64>(static_cast<int64>(Radius) + Node.MaxChildDistance, MAX_int32 - 1));
+				const int32 Distance = UDeduplicationFunctionLibrary::ComputeLevenshteinDistanceBounded(Name, Node.Name, Bound);
+				if (Distance > Bound)
+				{
+					continue;
+				}
+
+				if (Distance <= Radius && (BestGroup == INDEX_NONE || Node.GroupIndex < BestGroup) && Accepts(Distance))
+				{
+					BestGroup = Node.GroupIndex;
+				}
+
+				for (const TPair<int32, int32>& Edge : Node.Children)
+				{
+					if (FMath::Abs(Edge.Key - Distance) <= Radius)
+					{
+						Stack.Add(Edge.Value);
+					}
+				}
+			}
+			return BestGroup;
+		}
+
+	private:
+		struct FNode
+		{
+			FString Name;
+			int32 GroupIndex = INDEX_NONE;
+			int32 MaxChildDistance = 0;
+			TArray<TPair<int32, int32>, TInlineAllocator<4>> Children;
+		};
+
+		TArray<FNode> Nodes;
+	};
+}
+
 TArray<FDuplicateGroup> UEqualNameDeduplication::Internal_FindDuplicates_Implementation(const TArray<FAssetData>& AssetsToAnalyze)
 {
 	TArray<FDuplicateGroup> DuplicateGroups;
-	TMap<FString, TArray<FAssetData>> NameToAssetsMap;
+
+	// Groups in creation order. An asset joins the earliest group whose name passes the threshold, which the BK-tree finds without
+	// comparing against every group name.
+	TArray<TArray<FAssetData>> NameGroups;
+	EqualNameDeduplication::FNameBKTree NameTree;
+
+	BuildNormalizedNames(AssetsToAnalyze);
+
+	const int32 MaxAcceptedDistance = GetMaxAcceptedDistance();
+	const auto PassesThreshold = [this](int32 Distance)
+	{
+		return (1 - Distance * PenaltyByDistance) > SimilarityThreshold;
+	};
 
 	int32 TotalAssetsNumber = AssetsToAnalyze.Num();
 	if (TotalAssetsNumber > 0)
@@ -52,39 +155,27 @@ TArray<FDuplicateGroup> UEqualNameDeduplication::Internal_FindDuplicates_Impleme
 			}
 			
 			Counter++;
-			FString NormalizedName = NormalizeAssetName(Asset.AssetName.ToString());
+			const FString& NormalizedName = NormalizedNames.FindChecked(Asset.GetSoftObjectPath());
 
-			bool bAddedToExistingGroup = false;
-			for (auto& NamePair : NameToAssetsMap)
+			const int32 GroupIndex = NameTree.FindFirstGroup(NormalizedName, MaxAcceptedDistance, PassesThreshold);
+			if (GroupIndex != INDEX_NONE)
 			{
-				const FString& ExistingName = NamePair.Key;
-
-				int32 Distance = UDeduplicationFunctionLibrary::ComputeLevenshteinDistance(NormalizedName, ExistingName);
-				float Penalty;
-
-				if (bBlendPenaltyBySize)
+				NameGroups[GroupIndex].Add(Asset);
+			}
+			else
+			{
+				// An equal name that did not pass the threshold restarts its group, like re-adding the key of a name map.
+				const int32 ExistingGroup = NameTree.Add(NormalizedName, NameGroups.Num());
+				if (ExistingGroup == NameGroups.Num())
 				{
-					int32 MaxLength = FMath::Max(ExistingName.Len(), NormalizedName.Len());
-					Penalty = Distance / static_cast<float>(MaxLength) * PenaltyByDistance;
+					NameGroups.Add(TArray<FAssetData>{ Asset });
 				}
 				else
 				{
-					Penalty = Distance * PenaltyByDistance;
-				}
-
-				if ((1-Distance*PenaltyByDistance) > SimilarityThreshold)
-				{
-					NamePair.Value.Add(Asset);
-					bAddedToExistingGroup = true;
-					break;
+					NameGroups[ExistingGroup] = TArray<FAssetData>{ Asset };
 				}
 			}
 
-			if (!bAddedToExistingGroup)
-			{
-				NameToAssetsMap.Add(NormalizedName, TArray<FAssetData>{ Asset });
-			}
-
 			SetProgress(Counter);
 			OnDeduplicationProgressCompleted.Broadcast();
 		}
@@ -95,10 +186,10 @@ TArray<FDuplicateGroup> UEqualNameDeduplication::Internal_FindDuplicates_Impleme
 	}
 
 	{
-		int32 NumNames = NameToAssetsMap.Num();
+		int32 NumNames = NameGroups.Num();
 		int32 Counter = 0;
 
-		for (auto& NamePair : NameToAssetsMap)
+		for (const TArray<FAssetData>& AssetsWithSameName : NameGroups)
 		{
 			if (ShouldStop())
 			{
@@ -106,7 +197,6 @@ TArray<FDuplicateGroup> UEqualNameDeduplication::Internal_FindDuplicates_Impleme
 			}
 			
 			Counter++;
-			const TArray<FAssetData>& AssetsWithSameName = NamePair.Value;
 
 			if (AssetsWithSameName.Num() > 1)
 			{
@@ -119,6 +209,7 @@ TArray<FDuplicateGroup> UEqualNameDeduplication::Internal_FindDuplicates_Impleme
 		}
 	}
 
+	NormalizedNames.Empty();
 	return DuplicateGroups;
 }
 
@@ -134,6 +225,34 @@ float UEqualNameDeduplication::CalculateConfidenceScore_Implementation(const TAr
 	double TotalSimilarity = 0.0;
 	int64 PairCount = 0;
 
+	// Every distance from 1 / PenaltyByDistance on clamps to zero similarity, so the distance is not needed beyond that.
+	const int32 MaxUsefulDistance = PenaltyByDistance > 0.0f
+		? static_cast<int32>(FMath::Min(FMath::CeilToDouble(1.0 / PenaltyByDistance) + 1.0, static_cast<double>(MAX_int32 - 1)))
+		: MAX_int32 - 1;
+
+	// Names of assets outside the current run are normalized here, once per asset instead of once per pair.
+	TArray<const FString*> Names;
+	TArray<FString> LocalNames;
+	Names.Reserve(NumAssets);
+	LocalNames.Reserve(NumAssets);
+	FAssetNamePrefixTrie LocalPrefixTrie;
+	bool bLocalPrefixTrieBuilt = false;
+	for (const FAssetData& Asset : Assets)
+	{
+		if (const FString* CachedName = NormalizedNames.Find(Asset.GetSoftObjectPath()))
+		{
+			Names.Add(CachedName);
+			continue;
+		}
+
+		if (!bLocalPrefixTrieBuilt)
+		{
+			LocalPrefixTrie.Build(bIgnoreCommonPrefixes ? CommonPrefixesToIgnore : TArray<FString>(), bIgnoreCase);
+			bLocalPrefixTrieBuilt = true;
+		}
+		Names.Add(&LocalNames.Add_GetRef(NormalizeAssetName(Asset.AssetName.ToString(), LocalPrefixTrie)));
+	}
+
 	for (int32 IndexA = 0; IndexA < NumAssets - 1; ++IndexA)
 	{
 		if (ShouldStop())
@@ -141,13 +260,13 @@ float UEqualNameDeduplication::CalculateConfidenceScore_Implementation(const TAr
 			break;
 		}
 		
-		const FString NameA = NormalizeAssetName(Assets[IndexA].AssetName.ToString());
+		const FString& NameA = *Names[IndexA];
 
 		for (int32 IndexB = IndexA + 1; IndexB < NumAssets; ++IndexB)
 		{
-			const FString NameB = NormalizeAssetName(Assets[IndexB].AssetName.ToString());
+			const FString& NameB = *Names[IndexB];
 
-			const int32 Distance = UDeduplicationFunctionLibrary::ComputeLevenshteinDistance(NameA, NameB);
+			const int32 Distance = UDeduplicationFunctionLibrary::ComputeLevenshteinDistanceBounded(NameA, NameB, MaxUsefulDistance);
 			const float Penalty = static_cast<float>(Distance) * PenaltyByDistance;
 
 			const float Similarity = FMath::Clamp(1.0f - Penalty, 0.0f, 1.0f);
@@ -174,41 +293,126 @@ float UEqualNameDeduplication::CalculateComplexity_Implementation(const TArray<F
 
 bool UEqualNameDeduplication::AreNamesEqual(const FString& Name1, const FString& Name2) const
 {
-	FString NormalizedName1 = NormalizeAssetName(Name1);
-	FString NormalizedName2 = NormalizeAssetName(Name2);
+	FAssetNamePrefixTrie PrefixTrie;
+	PrefixTrie.Build(bIgnoreCommonPrefixes ? CommonPrefixesToIgnore : TArray<FString>(), bIgnoreCase);
+	FString NormalizedName1 = NormalizeAssetName(Name1, PrefixTrie);
+	FString NormalizedName2 = NormalizeAssetName(Name2, PrefixTrie);
 
-	int Distance = UDeduplicationFunctionLibrary::ComputeLevenshteinDistance(NormalizedName1, NormalizedName2);
+	const int32 MaxAcceptedDistance = GetMaxAcceptedDistance();
+	int Distance = UDeduplicationFunctionLibrary::ComputeLevenshteinDistanceBounded(NormalizedName1, NormalizedName2, MaxAcceptedDistance);
 
-	return (1 - Distance * PenaltyByDistance) > SimilarityThreshold;
+	return Distance <= MaxAcceptedDistance && (1 - Distance * PenaltyByDistance) > SimilarityThreshold;
 }
 
-
-FString UEqualNameDeduplication::NormalizeAssetName(const FString& AssetName) const
+int32 UEqualNameDeduplication::GetMaxAcceptedDistance() const
 {
-	FString NormalizedName = AssetName;
-	
-	if (bIgnoreExtensions)
+	if (PenaltyByDistance <= 0.0f)
 	{
-		NormalizedName = FPaths::GetBaseFilename(NormalizedName);
+		return MAX_int32 - 1;
 	}
+
+	// One extra step of slack for float rounding, the exact threshold test is still applied to the distance.
+	const double MaxDistance = FMath::FloorToDouble((1.0 - SimilarityThreshold) / PenaltyByDistance) + 1.0;
+	return static_cast<int32>(FMath::Clamp(MaxDistance, 0.0, static_cast<double>(MAX_int32 - 1)));
+}
+
+
+FString UEqualNameDeduplication::NormalizeAssetName(const FString& AssetName, const FAssetNamePrefixTrie& PrefixTrie) const
+{
+	FString NormalizedName = bIgnoreExtensions ? FPaths::GetBaseFilename(AssetName) : AssetName;
 	
 	if (bIgnoreCommonPrefixes)
 	{
-		for (const FString& Prefix : CommonPrefixesToIgnore)
+		const int32 PrefixLength = PrefixTrie.FindPrefixLength(NormalizedName);
+		if (PrefixLength > 0)
 		{
-			if (NormalizedName.StartsWith(Prefix, bIgnoreCase ? ESearchCase::IgnoreCase : ESearchCase::CaseSensitive))
-			{
-				NormalizedName = NormalizedName.Mid(Prefix.Len());
-				break; 
-			}
+			NormalizedName.RightChopInline(PrefixLength, EAllowShrinking::No);
 		}
 	}
 	
 	if (bIgnoreCase)
 	{
-		NormalizedName = NormalizedName.ToLower();
+		NormalizedName.ToLowerInline();
 	}
 	
 	return NormalizedName;
 }
 
+void UEqualNameDeduplication::BuildNormalizedNames(const TArray<FAssetData>& Assets)
+{
+	FAssetNamePrefixTrie PrefixTrie;
+	PrefixTrie.Build(bIgnoreCommonPrefixes ? CommonPrefixesToIgnore : TArray<FString>(), bIgnoreCase);
+
+	NormalizedNames.Reset();
+	NormalizedNames.Reserve(Assets.Num());
+	for (const FAssetData& Asset : Assets)
+	{
+		NormalizedNames.Add(Asset.GetSoftObjectPath(), NormalizeAssetName(Asset.AssetName.ToString(), PrefixTrie));
+	}
+}
+
+void FAssetNamePrefixTrie::Build(const TArray<FString>& Prefixes, bool bInIgnoreCase)
+{
+	bIgnoreCase = bInIgnoreCase;
+	Nodes.Reset();
+	Nodes.AddDefaulted();
+
+	for (int32 PrefixIndex = 0; PrefixIndex < Prefixes.Num(); ++PrefixIndex)
+	{
+		const FString& Prefix = Prefixes[PrefixIndex];
+		int32 NodeIndex = 0;
+		for (TCHAR Character : Prefix)
+		{
+			const TCHAR Key = bIgnoreCase ? FChar::ToLower(Character) : Character;
+			const TPair<TCHAR, int32>* Child = Nodes[NodeIndex].Children.FindByPredicate([Key](const TPair<TCHAR, int32>& Edge) { return Edge.Key == Key; });
+			if (Child != nullptr)
+			{
+				NodeIndex = Child->Value;
+				continue;
+			}
+
+			const int32 NewIndex = Nodes.AddDefaulted();
+			Nodes[NodeIndex].Children.Emplace(Key, NewIndex);
+			NodeIndex = NewIndex;
+		}
+
+		// A prefix listed twice keeps its first position, as the linear scan would.
+		if (Nodes[NodeIndex].PrefixIndex == INDEX_NONE)
+		{
+			Nodes[NodeIndex].PrefixIndex = PrefixIndex;
+			Nodes[NodeIndex].PrefixLength = Prefix.Len();
+		}
+	}
+}
+
+int32 FAssetNamePrefixTrie::FindPrefixLength(FStringView Name) const
+{
+	if (Nodes.IsEmpty())
+	{
+		return INDEX_NONE;
+	}
+
+	// Every prefix on the path matches, the one listed first wins like in the former linear scan.
+	int32 BestIndex = Nodes[0].PrefixIndex;
+	int32 BestLength = BestIndex != INDEX_NONE ? Nodes[0].PrefixLength : INDEX_NONE;
+	int32 NodeIndex = 0;
+	for (TCHAR Character : Name)
+	{
+		const TCHAR Key = bIgnoreCase ? FChar::ToLower(Character) : Character;
+		const TPair<TCHAR, int32>* Child = Nodes[NodeIndex].Children.FindByPredicate([Key](const TPair<TCHAR, int32>& Edge) { return Edge.Key == Key; });
+		if (Child == nullptr)
+		{
+			break;
+		}
+
+		NodeIndex = Child->Value;
+		const FNode& Node = Nodes[NodeIndex];
+		if (Node.PrefixIndex != INDEX_NONE && (BestIndex == INDEX_NONE || Node.PrefixIndex < BestIndex))
+		{
+			BestIndex = Node.PrefixIndex;
+			BestLength = Node.PrefixLength;
+		}
+	}
+	return BestLength;
+}
+
@@ -5,18 +5,55 @@
  */
 
 #include "DeduplicateObjects/EqualNeedlemanWunschDataDeduplication.h"
+#include "DeduplicationSimdKernels.h"
 #include "Engine/AssetManager.h"
 #include "HAL/PlatformFilemanager.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 
+namespace EqualNeedlemanWunschDataDeduplication
+{
+	static const int32 NegInf = INT32_MIN / 4;
+
+	// Score of a cell of one of the H, E, F matrices together with the statistics of the backtrace path that starts in this cell.
+	struct FAlignmentCell
+	{
+		int32 Score = NegInf;
+		int32 Matches = 0;
+		int32 Length = 0;
+	};
+
+	static FAlignmentCell Extend(const FAlignmentCell& From, int32 Score, bool bMatch)
+	{
+		FAlignmentCell Cell;
+		Cell.Score = Score;
+		Cell.Matches = From.Matches + (bMatch ? 1 : 0);
+		Cell.Length = From.Length + 1;
+		return Cell;
+	}
+
+	static void PathFrom(const FAlignmentCell& From, int32 Score, FAlignmentCell& OutCell)
+	{
+		OutCell.Score = Score;
+		OutCell.Matches = From.Matches;
+		OutCell.Length = From.Length;
+	}
+}
+
 UEqualNeedlemanWunschDataDeduplication::UEqualNeedlemanWunschDataDeduplication()
 {
 	SimilarityThreshold = 0.7f;
 }
 
-float UEqualNeedlemanWunschDataDeduplication::CalculateBinarySimilarity(const TArray<uint8>& Data1, const TArray<uint8>& Data2) const
+bool UEqualNeedlemanWunschDataDeduplication::SupportsAlignmentPrefilter() const
+{
+	return true;
+}
+
+float UEqualNeedlemanWunschDataDeduplication::CalculateBinarySimilarity(TArrayView<const uint8> Data1, TArrayView<const uint8> Data2) const
 {
+	using namespace EqualNeedlemanWunschDataDeduplication;
+
 	if (Data1.Num() == 0 || Data2.Num() == 0)
 	{
 		return 0.0f;
@@ -24,213 +61,151 @@ float UEqualNeedlemanWunschDataDeduplication::CalculateBinarySimilarity(const TA
 
 	const int32 LengthA = Data1.Num();
 	const int32 LengthB = Data2.Num();
-
-	const int32 Width = LengthB + 1;
-	const int32 Height = LengthA + 1;
-
-	const int64 Width64 = static_cast<int64>(Width);
-	const int64 Height64 = static_cast<int64>(Height);
-	const int64 Size = Width64 * Height64;
-
-	if (Size <= 0 || Size > INT32_MAX)
+	const uint8* BytesA = Data1.GetData();
+	const uint8* BytesB = Data2.GetData();
+
+	// The backtrace of the full matrix version is replayed forward: every cell carries the match count and length of the path that the
+	// backtrace would follow from it, with the same tie breaking, so only two rows of each matrix are needed and the result is unchanged.
+	// With the band enabled only the columns [Row - BandBelow, Row + BandAbove] are evaluated, which keeps both corners inside the band.
+	int32 BandBelow = LengthA;
+	int32 BandAbove = LengthB;
+	if (bUseDiagonalBand)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Too much elements for EqualNeedlemenDataDeduplication or invalid size: %lld"), Size);
-		return 0.0f;
+		const int32 Slack = FMath::Max(MinBandWidth, FMath::CeilToInt32(BandWidthRatio * FMath::Max(LengthA, LengthB)));
+		BandBelow = Slack + FMath::Max(0, LengthA - LengthB);
+		BandAbove = Slack + FMath::Max(0, LengthB - LengthA);
 	}
 
-	const int32 TotalCells = Width * Height;
-
-	const int32 NegInf = INT32_MIN / 4;
-
-	TArray<int32> H;
-	TArray<int32> E;
-	TArray<int32> F;
-
-	H.Init(NegInf, TotalCells);
-	E.Init(NegInf, TotalCells);
-	F.Init(NegInf, TotalCells);
-
-	auto Idx = [Width](int32 Row, int32 Col) { return Row * Width + Col; };
-
-	H[Idx(0, 0)] = 0;
-	E[Idx(0, 0)] = NegInf;
-	F[Idx(0, 0)] = NegInf;
-
-	for (int32 Row = 1; Row <= LengthA; ++Row)
+	if (bUseVectorizedKernel)
 	{
-		int32 Index = Idx(Row, 0);
-		E[Index] = GapOpen + (Row - 1) * GapExtend;
-		H[Index] = NegInf;
-		F[Index] = NegInf;
+		FDeduplicationGotohScoring Scoring;
+		Scoring.MatchScore = MatchScore;
+		Scoring.MismatchScore = MismatchScore;
+		Scoring.GapOpen = GapOpen;
+		Scoring.GapExtend = GapExtend;
+		Scoring.BandBelow = BandBelow;
+		Scoring.BandAbove = BandAbove;
+
+		FDeduplicationGotohPathStats Stats;
+		if (FDeduplicationSimdKernels::AlignGotoh(Data1, Data2, Scoring, [this]() { return ShouldStop(); }, Stats))
+		{
+			if (Stats.Length == 0)
+			{
+				return 0.0f;
+			}
+			return FMath::Clamp(static_cast<float>(Stats.Matches) / static_cast<float>(Stats.Length), 0.0f, 1.0f);
+		}
 	}
 
-	for (int32 Col = 1; Col <= LengthB; ++Col)
+	auto RowBegin = [BandBelow](int32 Row) { return FMath::Max(0, Row - BandBelow); };
+	auto RowEnd = [BandAbove, LengthB](int32 Row) { return static_cast<int32>(FMath::Min<int64>(LengthB, static_cast<int64>(Row) + BandAbove)); };
+
+	// Rows only store their band: column Col of a row lives in slot Col - RowBegin(Row) + 1. Slot 0 and the slot after the band stay
+	// unreachable, so reads of the cells left of the band and above the first cell right of it need no special cases.
+	const int32 MaxRowWidth = static_cast<int32>(FMath::Min<int64>(LengthB, static_cast<int64>(BandBelow) + BandAbove)) + 1;
+	const int32 Capacity = MaxRowWidth + 2;
+	TArray<FAlignmentCell> PrevH, PrevE, PrevF, CurH, CurE, CurF;
+	PrevH.SetNum(Capacity);
+	PrevE.SetNum(Capacity);
+	PrevF.SetNum(Capacity);
+	CurH.SetNum(Capacity);
+	CurE.SetNum(Capacity);
+	CurF.SetNum(Capacity);
+
+	const int32 GapStart = GapOpen + GapExtend;
+
+	// Row 0: H(0,0) = 0, F runs along the row, a path reaching E in row 0 or F in column 0 ends the backtrace.
+	PrevH[1].Score = 0;
+	const int32 FirstRowEnd = RowEnd(0);
+	for (int32 Col = 1; Col <= FirstRowEnd; ++Col)
 	{
-		int32 Index = Idx(0, Col);
-		F[Index] = GapOpen + (Col - 1) * GapExtend;
-		H[Index] = NegInf;
-		E[Index] = NegInf;
+		const FAlignmentCell& LeftH = PrevH[Col];
+		const FAlignmentCell& LeftF = PrevF[Col];
+		const FAlignmentCell& From = (LeftF.Score + GapExtend >= LeftH.Score + GapStart) ? LeftF : LeftH;
+		PrevF[Col + 1] = Extend(From, GapOpen + (Col - 1) * GapExtend, false);
+		PathFrom(PrevF[Col + 1], NegInf, PrevH[Col + 1]);
 	}
 
+	int32 PrevBegin = 0;
 	for (int32 Row = 1; Row <= LengthA; ++Row)
 	{
 		if (ShouldStop())
 		{
 			return 0.0f;
 		}
-		
-		for (int32 Col = 1; Col <= LengthB; ++Col)
-		{
-			int32 Index = Idx(Row, Col);
-			int32 IndexDiag = Idx(Row - 1, Col - 1);
-			int32 IndexUp = Idx(Row - 1, Col);
-			int32 IndexLeft = Idx(Row, Col - 1);
-
-			// E: ������� �� B (����� ������ �� A, B ����� '-')
-			int32 FromHToE = H[IndexUp] + GapOpen + GapExtend;
-			int32 FromEToE = E[IndexUp] + GapExtend;
-			E[Index] = (FromHToE > FromEToE) ? FromHToE : FromEToE;
-
-			// F: ������� �� A (����� ������ �� B, A ����� '-')
-			int32 FromHToF = H[IndexLeft] + GapOpen + GapExtend;
-			int32 FromFToF = F[IndexLeft] + GapExtend;
-			F[Index] = (FromHToF > FromFToF) ? FromHToF : FromFToF;
-
-			// H: ��������� (match/mismatch)
-			int32 BestPrev = H[IndexDiag];
-			if (E[IndexDiag] > BestPrev) BestPrev = E[IndexDiag];
-			if (F[IndexDiag] > BestPrev) BestPrev = F[IndexDiag];
-
-			int32 SubScore = (Data1[Row - 1] == Data2[Col - 1]) ? MatchScore : MismatchScore;
-			H[Index] = BestPrev + SubScore;
-		}
-	}
 
-	// �������� backtrace � ��������� � ������-������ ����
-	int32 LastIndex = Idx(LengthA, LengthB);
-	int32 CurrentMatrix = 0; // 0 = H, 1 = E, 2 = F
-	int32 BestEndValue = H[LastIndex];
-	if (E[LastIndex] > BestEndValue) { BestEndValue = E[LastIndex]; CurrentMatrix = 1; }
-	if (F[LastIndex] > BestEndValue) { BestEndValue = F[LastIndex]; CurrentMatrix = 2; }
+		const int32 Begin = RowBegin(Row);
+		const int32 End = RowEnd(Row);
+		const int32 RowWidth = End - Begin + 1;
 
-	int32 RowPtr = LengthA;
-	int32 ColPtr = LengthB;
-	int32 MatchingCount = 0;
-	int32 AlignmentLength = 0;
-
-	// Backtrace: ��������������� ������������ � ������� ����������
-	while (RowPtr > 0 || ColPtr > 0)
-	{
-		if (ShouldStop())
+		// The row still holds values of two rows ago.
+		for (int32 Slot = 0; Slot <= RowWidth + 1; ++Slot)
 		{
-			return 0.0f;
+			CurH[Slot] = FAlignmentCell();
+			CurE[Slot] = FAlignmentCell();
+			CurF[Slot] = FAlignmentCell();
 		}
-		
-		if (CurrentMatrix == 0) // H: ���������
-		{
-			// ���� �������� ���� � ������������� � ��������������� ������� ���������
-			if (RowPtr == 0 || ColPtr == 0)
-			{
-				if (RowPtr > 0) CurrentMatrix = 1; // E (��������� ����� �� Row)
-				else if (ColPtr > 0) CurrentMatrix = 2; // F (��������� ����� �� Col)
-				else break;
-				continue;
-			}
-
-			// ������� ������� H[Index] = max(H,E,F at diag) + SubScore
-			int32 Index = Idx(RowPtr, ColPtr);
-			int32 IndexDiag = Idx(RowPtr - 1, ColPtr - 1);
-			int32 SubScore = (Data1[RowPtr - 1] == Data2[ColPtr - 1]) ? MatchScore : MismatchScore;
-
-			// ��������� ����������/�� ����������
-			++AlignmentLength;
-			if (Data1[RowPtr - 1] == Data2[ColPtr - 1])
-			{
-				++MatchingCount;
-			}
 
-			// ��������� �� ���������
-			// ��������, ������ ������: H, E ��� F �� ���������
-			int32 PrevH = H[IndexDiag];
-			int32 PrevE = E[IndexDiag];
-			int32 PrevF = F[IndexDiag];
+		// Slot of column Col in the current row, and the distance to the slot of the same column in the previous row.
+		const int32 CurOffset = 1 - Begin;
+		const int32 PrevOffset = 1 - PrevBegin;
 
-			int32 PrevBest = PrevH;
-			CurrentMatrix = 0;
-			if (PrevE > PrevBest) { PrevBest = PrevE; CurrentMatrix = 1; }
-			if (PrevF > PrevBest) { PrevBest = PrevF; CurrentMatrix = 2; }
-
-			RowPtr -= 1;
-			ColPtr -= 1;
-		}
-		else if (CurrentMatrix == 1) // E: ������������ ������� (��������� �� Row)
+		int32 Col = Begin;
+		if (Col == 0)
 		{
-			// ���� ColPtr==0, �� ����� ������ ��������� �� Row �� ����
-			if (RowPtr == 0)
-			{
-				// �������� �� ������������
-				break;
-			}
-
-			++AlignmentLength;
-			// ��� �������� ���������� �� ��������� � MatchingCount
-			int32 Index = Idx(RowPtr, ColPtr);
-			int32 IndexUp = Idx(RowPtr - 1, ColPtr);
-
-			// ���������, ������ ������: E[Index] = max(H[IndexUp] + GapOpen+GapExtend, E[IndexUp] + GapExtend)
-			int32 FromE = E[IndexUp] + GapExtend;
-			int32 FromH = H[IndexUp] + GapOpen + GapExtend;
-
-			if (FromE >= FromH)
-			{
-				CurrentMatrix = 1; // ����������� E
-			}
-			else
-			{
-				CurrentMatrix = 0; // ������ �� H (�������� ��������)
-			}
-
-			RowPtr -= 1;
+			const FAlignmentCell& UpH = PrevH[PrevOffset];
+			const FAlignmentCell& UpE = PrevE[PrevOffset];
+			const FAlignmentCell& From = (UpE.Score + GapExtend >= UpH.Score + GapStart) ? UpE : UpH;
+			CurE[CurOffset] = Extend(From, GapOpen + (Row - 1) * GapExtend, false);
+			PathFrom(CurE[CurOffset], NegInf, CurH[CurOffset]);
+			++Col;
 		}
-		else // CurrentMatrix == 2, F: �������������� ������� (��������� �� Col)
-		{
-			if (ColPtr == 0)
-			{
-				break;
-			}
-
-			++AlignmentLength;
-			int32 Index = Idx(RowPtr, ColPtr);
-			int32 IndexLeft = Idx(RowPtr, ColPtr - 1);
 
-			// F[Index] = max(H[IndexLeft] + GapOpen+GapExtend, F[IndexLeft] + GapExtend)
-			int32 FromF = F[IndexLeft] + GapExtend;
-			int32 FromH = H[IndexLeft] + GapOpen + GapExtend;
-
-			if (FromF >= FromH)
-			{
-				CurrentMatrix = 2; // ����������� F
-			}
-			else
-			{
-				CurrentMatrix = 0; // ������ �� H (�������� ��������)
-			}
-
-			ColPtr -= 1;
+		const uint8 ByteA = BytesA[Row - 1];
+		for (; Col <= End; ++Col)
+		{
+			const int32 Slot = Col + CurOffset;
+			const int32 UpSlot = Col + PrevOffset;
+
+			// E: gap in B, comes from the cell above.
+			const FAlignmentCell& UpH = PrevH[UpSlot];
+			const FAlignmentCell& UpE = PrevE[UpSlot];
+			const int32 FromHToE = UpH.Score + GapStart;
+			const int32 FromEToE = UpE.Score + GapExtend;
+			CurE[Slot] = (FromHToE > FromEToE) ? Extend(UpH, FromHToE, false) : Extend(UpE, FromEToE, false);
+
+			// F: gap in A, comes from the cell on the left.
+			const FAlignmentCell& LeftH = CurH[Slot - 1];
+			const FAlignmentCell& LeftF = CurF[Slot - 1];
+			const int32 FromHToF = LeftH.Score + GapStart;
+			const int32 FromFToF = LeftF.Score + GapExtend;
+			CurF[Slot] = (FromHToF > FromFToF) ? Extend(LeftH, FromHToF, false) : Extend(LeftF, FromFToF, false);
+
+			// H: match or mismatch on the diagonal.
+			const FAlignmentCell* BestPrev = &PrevH[UpSlot - 1];
+			if (PrevE[UpSlot - 1].Score > BestPrev->Score) BestPrev = &PrevE[UpSlot - 1];
+			if (PrevF[UpSlot - 1].Score > BestPrev->Score) BestPrev = &PrevF[UpSlot - 1];
+
+			const bool bMatch = ByteA == BytesB[Col - 1];
+			CurH[Slot] = Extend(*BestPrev, BestPrev->Score + (bMatch ? MatchScore : MismatchScore), bMatch);
 		}
+
+		Swap(PrevH, CurH);
+		Swap(PrevE, CurE);
+		Swap(PrevF, CurF);
+		PrevBegin = Begin;
 	}
 
-	// ������ �� ������� �� ���� (� ������ �� ����� ���� AlignmentLength==0, �� �� ������ ������)
-	if (AlignmentLength == 0)
+	// The band always reaches the last column, see the band bounds above.
+	const int32 LastSlot = LengthB - PrevBegin + 1;
+	const FAlignmentCell* Last = &PrevH[LastSlot];
+	if (PrevE[LastSlot].Score > Last->Score) Last = &PrevE[LastSlot];
+	if (PrevF[LastSlot].Score > Last->Score) Last = &PrevF[LastSlot];
+
+	if (Last->Length == 0)
 	{
 		return 0.0f;
 	}
 
-	// ���� ����������� ������ � ����������� ������������������
-	float Similarity = (float)MatchingCount / (float)AlignmentLength;
-	// ��������� ������ � �������� [0,1]
-	if (Similarity < 0.0f) Similarity = 0.0f;
-	if (Similarity > 1.0f) Similarity = 1.0f;
-
-	return Similarity;
+	return FMath::Clamp(static_cast<float>(Last->Matches) / static_cast<float>(Last->Length), 0.0f, 1.0f);
 }
@@ -10,28 +10,44 @@
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 #include "DeduplicationFunctionLibrary.h"
+#include "DeduplicationSimdKernels.h"
 
 UEqualSimpleUassetDataDeduplication::UEqualSimpleUassetDataDeduplication()
 {
 	MinCommonSubstringLength = 4;
 }
 
-float UEqualSimpleUassetDataDeduplication::CalculateBinarySimilarity(const TArray<uint8>& Data1, const TArray<uint8>& Data2) const
+float UEqualSimpleUassetDataDeduplication::CalculateBinarySimilarity(TArrayView<const uint8> Data1, TArrayView<const uint8> Data2) const
 {
+	// Cancellation is checked once per stride instead of once per byte, the vectorized counter handles the stride in one call.
+	static const int32 StopCheckStride = 1024 * 1024;
+
+	if (bUseCommonSubstringSimilarity)
+	{
+		// Grams of the shorter asset found in the longer one, divided by the gram count of the longer one so a size mismatch lowers the score.
+		const TArrayView<const uint8> Shorter = Data1.Num() <= Data2.Num() ? Data1 : Data2;
+		const TArrayView<const uint8> Longer = Data1.Num() <= Data2.Num() ? Data2 : Data1;
+		const int32 GramLength = FMath::Max(1, MinCommonSubstringLength);
+		const int32 NumLongerGrams = Longer.Num() - GramLength + 1;
+		if (NumLongerGrams <= 0)
+		{
+			return Shorter.Num() == Longer.Num() && FMemory::Memcmp(Shorter.GetData(), Longer.GetData(), Shorter.Num()) == 0 ? 1.0f : 0.0f;
+		}
+		return (float)UDeduplicationFunctionLibrary::FindCommonSubstrings(Shorter, Longer, GramLength) / (float)NumLongerGrams;
+	}
+
 	int32 MinSize = FMath::Min(Data1.Num(), Data2.Num());
-	int32 MatchingBytes = 0;
+	int64 MatchingBytes = 0;
 
-	for (int32 i = 0; i < MinSize; i++)
+	for (int32 Offset = 0; Offset < MinSize; Offset += StopCheckStride)
 	{
 		if (ShouldStop())
 		{
 			return 0.0f;
 		}
-		
-		if (Data1[i] == Data2[i])
-		{
-			MatchingBytes++;
-		}
+
+		const int32 StrideSize = FMath::Min(StopCheckStride, MinSize - Offset);
+		MatchingBytes += FDeduplicationSimdKernels::CountEqualBytes(Data1.GetData() + Offset, Data2.GetData() + Offset, StrideSize);
 	}
 
 	float ByteSimilarity = (float)MatchingBytes / (float)MinSize;
@@ -39,4 +55,3 @@ float UEqualSimpleUassetDataDeduplication::CalculateBinarySimilarity(const TArra
 
 	return ByteSimilarity;
 }
-
@@ -21,18 +21,65 @@
 #include "NiagaraEmitter.h"
 #include "NiagaraSystem.h"
 #include "Engine/MapBuildDataRegistry.h"
+#include "Algo/Sort.h"
+#include "Containers/Ticker.h"
+#include "HAL/Event.h"
+#include <atomic>
+
+namespace EqualSizeDeduplication
+{
+	// Resource sizes of a run, gathered on the game thread by a ticker a few milliseconds per tick.
+	// Shared with the ticker, so a cancelled run can return while the last tick is still pending.
+	struct FResourceSizeBatch
+	{
+		TArray<FAssetData> Assets;
+		TArray<int32> AssetIndices;
+		TArray<int64> Sizes;
+		int32 NextIndex = 0;
+		double TimeSliceSeconds = 0.005;
+		std::atomic<bool> bCancelled = false;
+		FEventRef DoneEvent{ EEventMode::ManualReset };
+
+		// Measures assets until the time slice is used up. Returns true once every asset is measured or the batch is cancelled.
+		bool Tick()
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			while (NextIndex < Assets.Num() && !bCancelled)
+			{
+				UObject* AssetObj = Assets[NextIndex].GetAsset();
+				Sizes[NextIndex] = AssetObj ? AssetObj->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal) : -1;
+				++NextIndex;
+
+				if (FPlatformTime::Seconds() - StartTime >= TimeSliceSeconds)
+				{
+					break;
+				}
+			}
+			return NextIndex >= Assets.Num() || bCancelled;
+		}
+	};
+}
 
 
 TArray<FDuplicateGroup> UEqualSizeDeduplication::Internal_FindDuplicates_Implementation(const TArray<FAssetData>& AssetsToAnalyze)
 {
 	TArray<FDuplicateGroup> DuplicateGroups;
-	TMap<int64, TArray<FAssetData>> SizeToAssetsMap;
+
+	// Every asset is measured once, then the sizes are sorted and swept.
+	TArray<TPair<int64, int32>> SortedSizes;
+	AssetSizes.Reset();
 
 	int32 TotalAssetsNumber = AssetsToAnalyze.Num();
 	if (TotalAssetsNumber > 0)
 	{
+		SortedSizes.Reserve(TotalAssetsNumber);
+		AssetSizes.Reserve(TotalAssetsNumber);
+
+		TArray<int64> Sizes;
+		CollectAssetSizes(AssetsToAnalyze, Sizes);
+
 		int32 Counter = 0;
-		for (const FAssetData& Asset : AssetsToAnalyze)
+		for (int32 AssetIndex = 0; AssetIndex < TotalAssetsNumber; ++AssetIndex)
 		{
 			if (ShouldStop())
 			{
@@ -40,40 +87,14 @@ TArray<FDuplicateGroup> UEqualSizeDeduplication::Internal_FindDuplicates_Impleme
 			}
 			
 			Counter++;
-			int64 AssetSize = GetAssetFileSize(Asset);
+			const FAssetData& Asset = AssetsToAnalyze[AssetIndex];
+			const int64 AssetSize = Sizes[AssetIndex];
+			AssetSizes.Add(Asset.GetSoftObjectPath(), AssetSize);
 
-			bool bAddedToExistingGroup = false;
-			for (auto& SizePair : SizeToAssetsMap)
+			// Assets whose size could not be determined are not grouped.
+			if (AssetSize >= 0)
 			{
-				const int64 ExistingSize = SizePair.Key;
-				int64 Difference = FMath::Abs(AssetSize - ExistingSize);
-				int64 MaxSize = FMath::Max(AssetSize, ExistingSize);
-
-				float Penalty = 0;
-				if (bBlendPenaltyBySize)
-				{
-					Penalty = static_cast<float>(Difference) / static_cast<float>(MaxSize) * PenaltyByDifferenceDistance;
-				}
-				else
-				{
-					Penalty = static_cast<float>(Difference) * PenaltyByDifferenceDistance;
-				}
-
-				if ((1.0f - Penalty) > SimilarityThreshold)
-				{
-					SizePair.Value.Add(Asset);
-					if (SizePair.Value.Num()>10)
-					{
-						UE_LOG(LogTemp, Warning, TEXT("Too much Data in same Groups. Potential Error or Wrong Setting"));
-					}
-					bAddedToExistingGroup = true;
-					break;
-				}
-			}
-
-			if (!bAddedToExistingGroup)
-			{
-				SizeToAssetsMap.Add(AssetSize, TArray<FAssetData>{ Asset });
+				SortedSizes.Emplace(AssetSize, AssetIndex);
 			}
 
 			SetProgress(Counter);
@@ -84,24 +105,44 @@ TArray<FDuplicateGroup> UEqualSizeDeduplication::Internal_FindDuplicates_Impleme
 		SetProgress(TotalAssetsNumber);
 	}
 
+	// Ties are ordered by input position, so the groups do not depend on the sort implementation.
+	Algo::Sort(SortedSizes);
+
+	// A group is anchored at its smallest size and takes every following size that still passes the threshold against the anchor.
+	// The penalty grows with the size, so the window ends at the first size that fails and that size anchors the next group.
+	int32 GroupBegin = 0;
+	while (GroupBegin < SortedSizes.Num() && !ShouldStop())
 	{
-		int32 NumSizes = SizeToAssetsMap.Num();
-		int32 Counter = 0;
+		const int64 AnchorSize = SortedSizes[GroupBegin].Key;
+		int32 GroupEnd = GroupBegin + 1;
+		while (GroupEnd < SortedSizes.Num() && (1.0f - GetSizePenalty(AnchorSize, SortedSizes[GroupEnd].Key)) > SimilarityThreshold)
+		{
+			++GroupEnd;
+		}
 
-		for (auto& SizePair : SizeToAssetsMap)
+		if (GroupEnd - GroupBegin > 1)
 		{
-			Counter++;
-			const TArray<FAssetData>& AssetsWithSameSize = SizePair.Value;
+			TArray<FAssetData> AssetsWithSameSize;
+			AssetsWithSameSize.Reserve(GroupEnd - GroupBegin);
+			for (int32 SortedIndex = GroupBegin; SortedIndex < GroupEnd; ++SortedIndex)
+			{
+				AssetsWithSameSize.Add(AssetsToAnalyze[SortedSizes[SortedIndex].Value]);
+			}
 
-			if (AssetsWithSameSize.Num() > 1)
+			if (AssetsWithSameSize.Num() > 10)
 			{
-				float ConfidenceScore = CalculateConfidenceScore(AssetsWithSameSize);
-				FDuplicateGroup DuplicateGroup = CreateDuplicateGroup(AssetsWithSameSize, ConfidenceScore);
-				DuplicateGroups.Add(DuplicateGroup);
+				UE_LOG(LogTemp, Warning, TEXT("Too much Data in same Groups. Potential Error or Wrong Setting"));
 			}
+
+			float ConfidenceScore = CalculateConfidenceScore(AssetsWithSameSize);
+			FDuplicateGroup DuplicateGroup = CreateDuplicateGroup(AssetsWithSameSize, ConfidenceScore);
+			DuplicateGroups.Add(DuplicateGroup);
 		}
+
+		GroupBegin = GroupEnd;
 	}
 
+	AssetSizes.Empty();
 	return DuplicateGroups;
 }
 
@@ -124,26 +165,12 @@ float UEqualSizeDeduplication::CalculateConfidenceScore_Implementation(const TAr
 			break;
 		}
 		
-		const int64 SizeA = GetAssetFileSize(Assets[IndexA]);
+		const int64 SizeA = GetCachedAssetSize(Assets[IndexA]);
 
 		for (int32 IndexB = IndexA + 1; IndexB < NumAssets; ++IndexB)
 		{
-			const int64 SizeB = GetAssetFileSize(Assets[IndexB]);
-
-			const int64 Difference = FMath::Abs(SizeA - SizeB);
-			const int64 MaxSize = FMath::Max(SizeA, SizeB);
-
-			float Penalty = 0.0f;
-			if (bBlendPenaltyBySize)
-			{
-				Penalty = (MaxSize == 0)
-					? 0.0f
-					: static_cast<float>(Difference) / static_cast<float>(MaxSize) * PenaltyByDifferenceDistance;
-			}
-			else
-			{
-				Penalty = static_cast<float>(Difference) * PenaltyByDifferenceDistance;
-			}
+			const int64 SizeB = GetCachedAssetSize(Assets[IndexB]);
+			const float Penalty = GetSizePenalty(SizeA, SizeB);
 
 			const float Similarity = FMath::Clamp(1.0f - Penalty, 0.0f, 1.0f);
 			TotalSimilarity += static_cast<double>(Similarity);
@@ -162,61 +189,110 @@ float UEqualSizeDeduplication::CalculateConfidenceScore_Implementation(const TAr
 
 
 
+float UEqualSizeDeduplication::GetSizePenalty(int64 SizeA, int64 SizeB) const
+{
+	const int64 Difference = FMath::Abs(SizeA - SizeB);
+	const int64 MaxSize = FMath::Max(SizeA, SizeB);
+
+	if (bBlendPenaltyBySize)
+	{
+		return (MaxSize == 0)
+			? 0.0f
+			: static_cast<float>(Difference) / static_cast<float>(MaxSize) * PenaltyByDifferenceDistance;
+	}
+	return static_cast<float>(Difference) * PenaltyByDifferenceDistance;
+}
+
+int64 UEqualSizeDeduplication::GetCachedAssetSize(const FAssetData& Asset) const
+{
+	if (const int64* CachedSize = AssetSizes.Find(Asset.GetSoftObjectPath()))
+	{
+		return *CachedSize;
+	}
+	return GetAssetFileSize(Asset);
+}
+
 int64 UEqualSizeDeduplication::GetAssetFileSize(const FAssetData& Asset) const
 {
-	if (UseLoadingSize)
+	TArray<int64> Sizes;
+	CollectAssetSizes(TArray<FAssetData>{ Asset }, Sizes);
+	return Sizes[0];
+}
+
+void UEqualSizeDeduplication::CollectAssetSizes(const TArray<FAssetData>& Assets, TArray<int64>& OutSizes) const
+{
+	using namespace EqualSizeDeduplication;
+
+	OutSizes.Init(-1, Assets.Num());
+
+	TSharedRef<FResourceSizeBatch, ESPMode::ThreadSafe> Batch = MakeShared<FResourceSizeBatch, ESPMode::ThreadSafe>();
+	Batch->TimeSliceSeconds = FMath::Max(ResourceSizeTimeSliceMs, 0.5f) / 1000.0;
+	for (int32 AssetIndex = 0; AssetIndex < Assets.Num(); ++AssetIndex)
 	{
-		if (UClass* AssetClass = Asset.GetClass(); AssetClass && (AssetClass->IsChildOf(UTexture::StaticClass()) || AssetClass->IsChildOf(UParticleSystem::StaticClass()) || AssetClass->IsChildOf(UNiagaraEmitter::StaticClass()) || AssetClass->IsChildOf(UNiagaraSystem::StaticClass()) ))
+		if (UseLoadingSize && UsesResourceSize(Assets[AssetIndex]))
 		{
-			int64 Size = -1;
-			UObject* AssetObj = Asset.GetAsset();
-			if (AssetObj)
-			{
-				UObject* CaptureAsset = AssetObj;
-				FEvent* WaitEvent = FPlatformProcess::GetSynchEventFromPool(true);
-				AsyncTask(ENamedThreads::ActualRenderingThread, [AssetObj, &Size, WaitEvent]()
-					{
-						Size = AssetObj ? AssetObj->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal) : -1;
-						WaitEvent->Trigger();
-					});
-
-				WaitEvent->Wait();
-				FPlatformProcess::ReturnSynchEventToPool(WaitEvent);
+			Batch->Assets.Add(Assets[AssetIndex]);
+			Batch->AssetIndices.Add(AssetIndex);
+		}
+	}
 
-				return Size;
+	if (!Batch->Assets.IsEmpty())
+	{
+		Batch->Sizes.Init(-1, Batch->Assets.Num());
+		if (IsInGameThread())
+		{
+			while (!Batch->Tick())
+			{
 			}
 		}
-		else if (AssetClass && (AssetClass->IsChildOf(UStaticMesh::StaticClass()) || AssetClass->IsChildOf(USkeletalMesh::StaticClass())))
+		else
 		{
-			int64 Size = -1;
-			FAssetData AssetCopy = Asset;
-			FEvent* WaitEvent = FPlatformProcess::GetSynchEventFromPool(true);
-			FGraphEventRef Task = FFunctionGraphTask::CreateAndDispatchWhenReady([&Size, AssetCopy, WaitEvent]()
+			FTSTicker::GetCoreTicker().AddTicker(TEXT("EqualSizeDeduplication.ResourceSizes"), 0.0f, [Batch](float)
 				{
-					UObject* AssetObj = AssetCopy.GetAsset();
-					Size = AssetObj ? AssetObj->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal) : -1;
-					WaitEvent->Trigger();
-				}, TStatId(), nullptr, ENamedThreads::GameThread);
-
-			WaitEvent->Wait();
-			FPlatformProcess::ReturnSynchEventToPool(WaitEvent);
+					if (!Batch->Tick())
+					{
+						return true;
+					}
+					Batch->DoneEvent->Trigger();
+					return false;
+				});
 
-			return Size;
+			while (!Batch->DoneEvent->Wait(FTimespan::FromMilliseconds(50)))
+			{
+				if (ShouldStop())
+				{
+					// The ticker may still be writing Sizes, so a cancelled batch is never read. The run is discarded anyway.
+					Batch->bCancelled = true;
+					return;
+				}
+			}
 		}
-		else if (AssetClass->IsChildOf(UWorld::StaticClass()) || AssetClass->IsChildOf(UMapBuildDataRegistry::StaticClass()))
+
+		for (int32 BatchIndex = 0; BatchIndex < Batch->Assets.Num(); ++BatchIndex)
 		{
-			//skip
+			OutSizes[Batch->AssetIndices[BatchIndex]] = Batch->Sizes[BatchIndex];
 		}
-		else
+	}
+
+	// Assets without a resource size, or whose object could not be loaded, are measured by their package file.
+	for (int32 AssetIndex = 0; AssetIndex < Assets.Num(); ++AssetIndex)
+	{
+		if (OutSizes[AssetIndex] < 0)
 		{
-			UObject* AssetObjFallback = Asset.GetAsset();
-			if (AssetObjFallback)
-			{
-				return AssetObjFallback->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
-			}
+			OutSizes[AssetIndex] = GetPackageFileSize(Assets[AssetIndex]);
 		}
 	}
+}
 
+bool UEqualSizeDeduplication::UsesResourceSize(const FAssetData& Asset)
+{
+	// Worlds and their build data are measured by file, loading them only for their size is too expensive.
+	const UClass* AssetClass = Asset.GetClass();
+	return AssetClass != nullptr && !AssetClass->IsChildOf(UWorld::StaticClass()) && !AssetClass->IsChildOf(UMapBuildDataRegistry::StaticClass());
+}
+
+int64 UEqualSizeDeduplication::GetPackageFileSize(const FAssetData& Asset)
+{
 	FString PackageName = Asset.PackageName.ToString();
 	FString Filename;
 
@@ -18,6 +18,7 @@
 #include "Kismet2/BlueprintEditorUtils.h"
 #include "Engine/Blueprint.h"
 #include "Misc/DefaultValueHelper.h"
+#include "DeduplicationFingerprintCache.h"
 
 bool FGraphNodeSignature::operator==(const FGraphNodeSignature& Other) const
 {
@@ -135,10 +136,11 @@ TArray<FDuplicateGroup> UGraphDeduplication::Internal_FindDuplicates_Implementat
 		return DuplicateGroups;
 	}
 
-	TArray<UObject*> LoadedObjects;
+	TArray<bool> ValidSignatures;
 	TArray<TArray<FGraphSignature>> ObjectGraphSignatures;
-	LoadedObjects.Reserve(AssetsToAnalyze.Num());
+	ValidSignatures.Reserve(AssetsToAnalyze.Num());
 	ObjectGraphSignatures.Reserve(AssetsToAnalyze.Num());
+	int32 NumValidSignatures = 0;
 
 	for (const FAssetData& AssetData : AssetsToAnalyze)
 	{
@@ -147,36 +149,57 @@ TArray<FDuplicateGroup> UGraphDeduplication::Internal_FindDuplicates_Implementat
 			break;
 		}
 		
-		UObject* LoadedObject = AssetData.GetAsset();
-		if (LoadedObject != nullptr)
-		{
-			LoadedObjects.Add(LoadedObject);
-			TArray<FGraphSignature> Signatures = ExtractGraphSignatures(LoadedObject);
-			ObjectGraphSignatures.Add(Signatures);
-		}
-		else
-		{
-			ObjectGraphSignatures.Add(TArray<FGraphSignature>());
-		}
+		TArray<FGraphSignature> Signatures;
+		const bool bValid = GetAssetGraphSignatures(AssetData, Signatures);
+		ValidSignatures.Add(bValid);
+		ObjectGraphSignatures.Add(MoveTemp(Signatures));
+		NumValidSignatures += bValid ? 1 : 0;
 	}
 
-	if (LoadedObjects.Num() < 2)
+	if (NumValidSignatures < 2)
 	{
 		return DuplicateGroups;
 	}
 
+	const int32 NumAssets = ObjectGraphSignatures.Num();
+	TArray<float> GraphSizes;
+	GraphSizes.Reserve(NumAssets);
+	for (const TArray<FGraphSignature>& Signatures : ObjectGraphSignatures)
+	{
+		GraphSizes.Add(CalculateGraphSize(Signatures));
+	}
+
+	const TArray<FDeduplicationSimilarPair> SimilarPairs = FindSimilarPairs(NumAssets, [this, &ValidSignatures, &ObjectGraphSignatures, &GraphSizes](int32 IndexA, int32 IndexB)
+		{
+			if (!ValidSignatures[IndexA] || !ValidSignatures[IndexB])
+			{
+				return -1.0f;
+			}
+
+			float Similarity = CompareGraphSignatures(ObjectGraphSignatures[IndexA], ObjectGraphSignatures[IndexB]);
+			
+			const float GraphSizeA = GraphSizes[IndexA];
+			const float GraphSizeB = GraphSizes[IndexB];
+			float MaxGraphSize = FMath::Max(GraphSizeA, GraphSizeB);
+			if (MaxGraphSize > 0.0f)
+			{
+				float SizePenalty = FMath::Abs(GraphSizeA - GraphSizeB) / MaxGraphSize;
+				Similarity = FMath::Clamp(Similarity - SizePenalty * PenaltyByNodeDifference, 0.0f, 1.0f);
+			}
+			return Similarity;
+		});
+
 	TMap<int32, TArray<FAssetData>> SimilarityGroups;
-	int32 TotalComparisons = LoadedObjects.Num() * (LoadedObjects.Num() - 1) / 2;
-	int32 CurrentComparison = 0;
+	int32 PairIndex = 0;
 
-	for (int32 IndexA = 0; IndexA < LoadedObjects.Num() - 1; ++IndexA)
+	for (int32 IndexA = 0; IndexA < NumAssets - 1; ++IndexA)
 	{
 		if (ShouldStop())
 		{
 			break;
 		}
 		
-		if (LoadedObjects[IndexA] == nullptr)
+		if (!ValidSignatures[IndexA])
 		{
 			continue;
 		}
@@ -184,57 +207,27 @@ TArray<FDuplicateGroup> UGraphDeduplication::Internal_FindDuplicates_Implementat
 		TArray<FAssetData> CurrentGroup;
 		CurrentGroup.Add(AssetsToAnalyze[IndexA]);
 
-		const TArray<FGraphSignature>& SignaturesA = ObjectGraphSignatures[IndexA];
-		float GraphSizeA = CalculateGraphSize(SignaturesA);
-
-		for (int32 IndexB = IndexA + 1; IndexB < LoadedObjects.Num(); ++IndexB)
+		while (PairIndex < SimilarPairs.Num() && SimilarPairs[PairIndex].IndexA < IndexA)
 		{
-			if (ShouldStop())
-			{
-				break;
-			}
-			
-			if (LoadedObjects[IndexB] == nullptr)
-			{
-				continue;
-			}
-
-			const TArray<FGraphSignature>& SignaturesB = ObjectGraphSignatures[IndexB];
-			float GraphSizeB = CalculateGraphSize(SignaturesB);
-
-			float Similarity = CompareGraphSignatures(SignaturesA, SignaturesB);
-			
-			float MaxGraphSize = FMath::Max(GraphSizeA, GraphSizeB);
-			if (MaxGraphSize > 0.0f)
-			{
-				float SizePenalty = FMath::Abs(GraphSizeA - GraphSizeB) / MaxGraphSize;
-				Similarity = FMath::Clamp(Similarity - SizePenalty * PenaltyByNodeDifference, 0.0f, 1.0f);
-			}
+			++PairIndex;
+		}
 
-			if (Similarity >= SimilarityThreshold)
+		for (; PairIndex < SimilarPairs.Num() && SimilarPairs[PairIndex].IndexA == IndexA; ++PairIndex)
+		{
+			const FAssetData& AssetB = AssetsToAnalyze[SimilarPairs[PairIndex].IndexB];
+			bool bAlreadyInGroup = false;
+			for (const FAssetData& ExistingAsset : CurrentGroup)
 			{
-				bool bAlreadyInGroup = false;
-				for (const FAssetData& ExistingAsset : CurrentGroup)
+				if (ExistingAsset == AssetB)
 				{
-					if (ExistingAsset == AssetsToAnalyze[IndexB])
-					{
-						bAlreadyInGroup = true;
-						break;
-					}
-				}
-
-				if (!bAlreadyInGroup)
-				{
-					CurrentGroup.Add(AssetsToAnalyze[IndexB]);
+					bAlreadyInGroup = true;
+					break;
 				}
 			}
 
-			CurrentComparison++;
-			if (CurrentComparison % 10 == 0)
+			if (!bAlreadyInGroup)
 			{
-				float ProgressValue = static_cast<float>(CurrentComparison) / static_cast<float>(TotalComparisons);
-				SetProgress(ProgressValue);
-				OnDeduplicationProgressCompleted.Broadcast();
+				CurrentGroup.Add(AssetB);
 			}
 		}
 
@@ -321,25 +314,20 @@ float UGraphDeduplication::CalculateConfidenceScore_Implementation(const TArray<
 		return 1.0f;
 	}
 
-	TArray<UObject*> LoadedObjects;
+	TArray<bool> ValidSignatures;
 	TArray<TArray<FGraphSignature>> ObjectGraphSignatures;
+	int32 NumValidSignatures = 0;
 
 	for (const FAssetData& AssetData : Assets)
 	{
-		UObject* LoadedObject = AssetData.GetAsset();
-		if (LoadedObject != nullptr)
-		{
-			LoadedObjects.Add(LoadedObject);
-			TArray<FGraphSignature> Signatures = ExtractGraphSignatures(LoadedObject);
-			ObjectGraphSignatures.Add(Signatures);
-		}
-		else
-		{
-			ObjectGraphSignatures.Add(TArray<FGraphSignature>());
-		}
+		TArray<FGraphSignature> Signatures;
+		const bool bValid = GetAssetGraphSignatures(AssetData, Signatures);
+		ValidSignatures.Add(bValid);
+		ObjectGraphSignatures.Add(MoveTemp(Signatures));
+		NumValidSignatures += bValid ? 1 : 0;
 	}
 
-	if (LoadedObjects.Num() < 2)
+	if (NumValidSignatures < 2)
 	{
 		return 0.0f;
 	}
@@ -347,14 +335,14 @@ float UGraphDeduplication::CalculateConfidenceScore_Implementation(const TArray<
 	double TotalSimilarity = 0.0;
 	int64 PairCount = 0;
 
-	for (int32 IndexA = 0; IndexA < LoadedObjects.Num() - 1; ++IndexA)
+	for (int32 IndexA = 0; IndexA < NumAssets - 1; ++IndexA)
 	{
 		if (ShouldStop())
 		{
 			break;
 		}
 		
-		if (LoadedObjects[IndexA] == nullptr)
+		if (!ValidSignatures[IndexA])
 		{
 			continue;
 		}
@@ -362,14 +350,14 @@ float UGraphDeduplication::CalculateConfidenceScore_Implementation(const TArray<
 		const TArray<FGraphSignature>& SignaturesA = ObjectGraphSignatures[IndexA];
 		float GraphSizeA = CalculateGraphSize(SignaturesA);
 
-		for (int32 IndexB = IndexA + 1; IndexB < LoadedObjects.Num(); ++IndexB)
+		for (int32 IndexB = IndexA + 1; IndexB < NumAssets; ++IndexB)
 		{
 			if (ShouldStop())
 			{
 				break;
 			}
 			
-			if (LoadedObjects[IndexB] == nullptr)
+			if (!ValidSignatures[IndexB])
 			{
 				continue;
 			}
@@ -407,6 +395,37 @@ float UGraphDeduplication::CalculateComplexity_Implementation(const TArray<FAsse
 	return AlgorithmComplexity;
 }
 
+bool UGraphDeduplication::IsAssetFeatureCached(const FAssetData& Asset) const
+{
+	return bUseFingerprintCache && FDeduplicationFingerprintCache::Get().HasFeature(Asset, GetCachedSignaturesName(), EDeduplicationFingerprintScope::ClassHierarchy);
+}
+
+FName UGraphDeduplication::GetCachedSignaturesName() const
+{
+	return FName(*FString::Printf(TEXT("Graph.Signatures.v2.Pins%d.Properties%d"), bComparePinNames ? 1 : 0, bCompareNodeProperties ? 1 : 0));
+}
+
+bool UGraphDeduplication::GetAssetGraphSignatures(const FAssetData& AssetData, TArray<FGraphSignature>& OutSignatures) const
+{
+	if (bUseFingerprintCache && FDeduplicationFingerprintCache::Get().FindFeature(AssetData, GetCachedSignaturesName(), OutSignatures, EDeduplicationFingerprintScope::ClassHierarchy))
+	{
+		return true;
+	}
+
+	UObject* LoadedObject = AssetData.GetAsset();
+	if (LoadedObject == nullptr)
+	{
+		return false;
+	}
+
+	OutSignatures = ExtractGraphSignatures(LoadedObject);
+	if (bUseFingerprintCache)
+	{
+		FDeduplicationFingerprintCache::Get().StoreFeature(AssetData, GetCachedSignaturesName(), OutSignatures, EDeduplicationFingerprintScope::ClassHierarchy);
+	}
+	return true;
+}
+
 TArray<FGraphSignature> UGraphDeduplication::ExtractGraphSignatures(UObject* Object) const
 {
 	TArray<FGraphSignature> Signatures;
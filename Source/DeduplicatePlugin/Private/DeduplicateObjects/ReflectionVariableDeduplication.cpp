@@ -13,6 +13,7 @@
 #include "Engine/AssetManager.h"
 #include "Misc/DefaultValueHelper.h"
 #include "Engine/Blueprint.h"
+#include "DeduplicationFingerprintCache.h"
 
 UReflectionVariableDeduplication::UReflectionVariableDeduplication()
 {
@@ -33,85 +34,64 @@ TArray<FDuplicateGroup> UReflectionVariableDeduplication::Internal_FindDuplicate
 		return DuplicateGroups;
 	}
 
-	TArray<UObject*> LoadedObjects;
-	TMap<int32, int32> LoadedObjectIndexToAssetIndex;
-	LoadedObjects.Reserve(AssetsToAnalyze.Num());
+	TArray<FReflectionFingerprint> Fingerprints;
+	TArray<int32> FingerprintIndexToAssetIndex;
+	Fingerprints.Reserve(AssetsToAnalyze.Num());
 
 	for (int32 AssetIndex = 0; AssetIndex < AssetsToAnalyze.Num(); ++AssetIndex)
 	{
-		const FAssetData& AssetData = AssetsToAnalyze[AssetIndex];
-		UObject* LoadedObject = AssetData.GetAsset();
-		if (LoadedObject != nullptr)
+		if (ShouldStop())
+		{
+			break;
+		}
+
+		FReflectionFingerprint Fingerprint;
+		if (GetAssetReflectionFingerprint(AssetsToAnalyze[AssetIndex], Fingerprint))
 		{
-			int32 LoadedObjectIndex = LoadedObjects.Add(LoadedObject);
-			LoadedObjectIndexToAssetIndex.Add(LoadedObjectIndex, AssetIndex);
+			Fingerprints.Add(MoveTemp(Fingerprint));
+			FingerprintIndexToAssetIndex.Add(AssetIndex);
 		}
 	}
 
-	if (LoadedObjects.Num() < 2)
+	if (Fingerprints.Num() < 2)
 	{
 		return DuplicateGroups;
 	}
 
+	const TArray<FDeduplicationSimilarPair> SimilarPairs = FindSimilarPairs(Fingerprints.Num(), [this, &Fingerprints](int32 IndexA, int32 IndexB)
+		{
+			return CompareReflectionFingerprints(Fingerprints[IndexA], Fingerprints[IndexB]);
+		});
+
 	TMap<int32, TArray<FAssetData>> SimilarityGroups;
-	int32 TotalComparisons = LoadedObjects.Num() * (LoadedObjects.Num() - 1) / 2;
-	int32 CurrentComparison = 0;
+	int32 PairIndex = 0;
 
-	for (int32 IndexA = 0; IndexA < LoadedObjects.Num() - 1; ++IndexA)
+	for (int32 IndexA = 0; IndexA < Fingerprints.Num() - 1; ++IndexA)
 	{
 		if (ShouldStop())
 		{
 			break;
 		}
-		
-		UObject* ObjectA = LoadedObjects[IndexA];
-		if (ObjectA == nullptr)
-		{
-			continue;
-		}
 
 		TArray<FAssetData> CurrentGroup;
-		CurrentGroup.Add(AssetsToAnalyze[IndexA]);
+		CurrentGroup.Add(AssetsToAnalyze[FingerprintIndexToAssetIndex[IndexA]]);
 
-		for (int32 IndexB = IndexA + 1; IndexB < LoadedObjects.Num(); ++IndexB)
+		for (; PairIndex < SimilarPairs.Num() && SimilarPairs[PairIndex].IndexA == IndexA; ++PairIndex)
 		{
-			if (ShouldStop())
-			{
-				break;
-			}
-			
-			UObject* ObjectB = LoadedObjects[IndexB];
-			if (ObjectB == nullptr)
+			const FAssetData& AssetB = AssetsToAnalyze[FingerprintIndexToAssetIndex[SimilarPairs[PairIndex].IndexB]];
+			bool bAlreadyInGroup = false;
+			for (const FAssetData& ExistingAsset : CurrentGroup)
 			{
-				continue;
-			}
-
-			float Similarity = CompareObjectsByReflection(ObjectA, ObjectB);
-			if (Similarity >= SimilarityThreshold)
-			{
-				int32 AssetIndexB = LoadedObjectIndexToAssetIndex[IndexB];
-				bool bAlreadyInGroup = false;
-				for (const FAssetData& ExistingAsset : CurrentGroup)
+				if (ExistingAsset == AssetB)
 				{
-					if (ExistingAsset == AssetsToAnalyze[AssetIndexB])
-					{
-						bAlreadyInGroup = true;
-						break;
-					}
-				}
-
-				if (!bAlreadyInGroup)
-				{
-					CurrentGroup.Add(AssetsToAnalyze[AssetIndexB]);
+					bAlreadyInGroup = true;
+					break;
 				}
 			}
 
-			CurrentComparison++;
-			if (CurrentComparison % 10 == 0)
+			if (!bAlreadyInGroup)
 			{
-				float ProgressValue = static_cast<float>(CurrentComparison) / static_cast<float>(TotalComparisons);
-				SetProgress(ProgressValue);
-				OnDeduplicationProgressCompleted.Broadcast();
+				CurrentGroup.Add(AssetB);
 			}
 		}
 
@@ -198,17 +178,17 @@ float UReflectionVariableDeduplication::CalculateConfidenceScore_Implementation(
 		return 1.0f;
 	}
 
-	TArray<UObject*> LoadedObjects;
+	TArray<FReflectionFingerprint> Fingerprints;
 	for (const FAssetData& AssetData : Assets)
 	{
-		UObject* LoadedObject = AssetData.GetAsset();
-		if (LoadedObject != nullptr)
+		FReflectionFingerprint Fingerprint;
+		if (GetAssetReflectionFingerprint(AssetData, Fingerprint))
 		{
-			LoadedObjects.Add(LoadedObject);
+			Fingerprints.Add(MoveTemp(Fingerprint));
 		}
 	}
 
-	if (LoadedObjects.Num() < 2)
+	if (Fingerprints.Num() < 2)
 	{
 		return 0.0f;
 	}
@@ -216,23 +196,11 @@ float UReflectionVariableDeduplication::CalculateConfidenceScore_Implementation(
 	double TotalSimilarity = 0.0;
 	int64 PairCount = 0;
 
-	for (int32 IndexA = 0; IndexA < LoadedObjects.Num() - 1; ++IndexA)
+	for (int32 IndexA = 0; IndexA < Fingerprints.Num() - 1; ++IndexA)
 	{
-		UObject* ObjectA = LoadedObjects[IndexA];
-		if (ObjectA == nullptr)
+		for (int32 IndexB = IndexA + 1; IndexB < Fingerprints.Num(); ++IndexB)
 		{
-			continue;
-		}
-
-		for (int32 IndexB = IndexA + 1; IndexB < LoadedObjects.Num(); ++IndexB)
-		{
-			UObject* ObjectB = LoadedObjects[IndexB];
-			if (ObjectB == nullptr)
-			{
-				continue;
-			}
-
-			float Similarity = CompareObjectsByReflection(ObjectA, ObjectB);
+			float Similarity = CompareReflectionFingerprints(Fingerprints[IndexA], Fingerprints[IndexB]);
 			TotalSimilarity += static_cast<double>(Similarity);
 			++PairCount;
 		}
@@ -254,79 +222,134 @@ float UReflectionVariableDeduplication::CalculateComplexity_Implementation(const
 	return AlgorithmComplexity;
 }
 
-float UReflectionVariableDeduplication::CompareObjectsByReflection(UObject* ObjectA, UObject* ObjectB) const
+bool UReflectionVariableDeduplication::IsAssetFeatureCached(const FAssetData& Asset) const
+{
+	return bUseFingerprintCache && FDeduplicationFingerprintCache::Get().HasFeature(Asset, GetCachedFingerprintName(), EDeduplicationFingerprintScope::ClassHierarchy);
+}
+
+FName UReflectionVariableDeduplication::GetCachedFingerprintName() const
+{
+	return FName(*FString::Printf(TEXT("Reflection.Fingerprint.v2.Visible%d.Transient%d.EditDefaults%d"),
+		bCompareOnlyVisibleProperties ? 1 : 0, bIgnoreTransientProperties ? 1 : 0, bIgnoreEditDefaultsOnlyProperties ? 1 : 0));
+}
+
+bool UReflectionVariableDeduplication::GetAssetReflectionFingerprint(const FAssetData& AssetData, FReflectionFingerprint& OutFingerprint) const
 {
-	if (ObjectA == nullptr || ObjectB == nullptr)
+	if (bUseFingerprintCache && FDeduplicationFingerprintCache::Get().FindFeature(AssetData, GetCachedFingerprintName(), OutFingerprint, EDeduplicationFingerprintScope::ClassHierarchy))
 	{
-		return 0.0f;
+		return true;
 	}
 
-	if (bRequireSameParentClass)
+	UObject* LoadedObject = AssetData.GetAsset();
+	if (LoadedObject == nullptr)
 	{
-		UClass* ParentClassA = GetCppParentClass(ObjectA);
-		UClass* ParentClassB = GetCppParentClass(ObjectB);
-
-		if (ParentClassA != ParentClassB)
-		{
-			return 0.0f;
-		}
+		return false;
 	}
 
-	UClass* ClassA = GetRealClass(ObjectA);
-	UClass* ClassB = GetRealClass(ObjectB);
-
-	if (ClassA == nullptr || ClassB == nullptr)
+	OutFingerprint = BuildReflectionFingerprint(LoadedObject);
+	if (bUseFingerprintCache)
 	{
-		return 0.0f;
+		FDeduplicationFingerprintCache::Get().StoreFeature(AssetData, GetCachedFingerprintName(), OutFingerprint, EDeduplicationFingerprintScope::ClassHierarchy);
 	}
+	return true;
+}
 
-	UObject* DefaultObjectA = ClassA->GetDefaultObject();
-	UObject* DefaultObjectB = ClassB->GetDefaultObject();
-
-	if (DefaultObjectA == nullptr || DefaultObjectB == nullptr)
+bool UReflectionVariableDeduplication::ShouldCompareProperty(const FProperty* Property) const
+{
+	if (Property == nullptr)
 	{
-		return 0.0f;
+		return false;
 	}
 
-	TMap<FName, FProperty*> PropertiesMapB;
-	for (TFieldIterator<FProperty> PropertyIterator(ClassB); PropertyIterator; ++PropertyIterator)
+	if (bCompareOnlyVisibleProperties)
 	{
-		FProperty* Property = *PropertyIterator;
-		if (Property == nullptr)
+		if (Property->HasAnyPropertyFlags(CPF_DisableEditOnInstance))
 		{
-			continue;
+			return false;
 		}
+	}
 
-		if (bCompareOnlyVisibleProperties)
+	if (bIgnoreTransientProperties)
+	{
+		if (Property->HasAnyPropertyFlags(CPF_Transient))
 		{
-			if (Property->HasAnyPropertyFlags(CPF_DisableEditOnInstance))
-			{
-				continue;
-			}
+			return false;
 		}
+	}
 
-		if (bIgnoreTransientProperties)
+	if (bIgnoreEditDefaultsOnlyProperties)
+	{
+		if (Property->HasAnyPropertyFlags(CPF_DisableEditOnInstance) && !Property->HasAnyPropertyFlags(CPF_Edit))
 		{
-			if (Property->HasAnyPropertyFlags(CPF_Transient))
-			{
-				continue;
-			}
+			return false;
 		}
+	}
 
-		if (bIgnoreEditDefaultsOnlyProperties)
-		{
-			if (Property->HasAnyPropertyFlags(CPF_DisableEditOnInstance) && !Property->HasAnyPropertyFlags(CPF_Edit))
-			{
-				continue;
-			}
-		}
+	return Property->HasAnyPropertyFlags(CPF_Edit | CPF_BlueprintVisible);
+}
 
-		if (!Property->HasAnyPropertyFlags(CPF_Edit | CPF_BlueprintVisible))
+FReflectionFingerprint UReflectionVariableDeduplication::BuildReflectionFingerprint(UObject* Object) const
+{
+	FReflectionFingerprint Fingerprint;
+	if (Object == nullptr)
+	{
+		return Fingerprint;
+	}
+
+	UClass* ParentClass = GetCppParentClass(Object);
+	Fingerprint.CppParentClassPath = ParentClass != nullptr ? ParentClass->GetPathName() : FString();
+
+	UClass* RealClass = GetRealClass(Object);
+	if (RealClass == nullptr)
+	{
+		return Fingerprint;
+	}
+
+	UObject* DefaultObject = RealClass->GetDefaultObject();
+	if (DefaultObject == nullptr)
+	{
+		return Fingerprint;
+	}
+
+	for (TFieldIterator<FProperty> PropertyIterator(RealClass); PropertyIterator; ++PropertyIterator)
+	{
+		FProperty* Property = *PropertyIterator;
+		if (!ShouldCompareProperty(Property))
 		{
 			continue;
 		}
 
-		PropertiesMapB.Add(Property->GetFName(), Property);
+		FReflectionPropertyFingerprint PropertyFingerprint;
+		PropertyFingerprint.PropertyName = Property->GetFName();
+		PropertyFingerprint.Signature = GetPropertySignature(Property);
+
+		const uint8* Value = static_cast<const uint8*>(Property->ContainerPtrToValuePtr<void>(DefaultObject));
+		Property->ExportTextItem_Direct(PropertyFingerprint.Value, Value, Value, nullptr, PPF_None, nullptr);
+
+		Fingerprint.Properties.Add(MoveTemp(PropertyFingerprint));
+	}
+
+	Fingerprint.bValid = true;
+	return Fingerprint;
+}
+
+float UReflectionVariableDeduplication::CompareReflectionFingerprints(const FReflectionFingerprint& FingerprintA, const FReflectionFingerprint& FingerprintB) const
+{
+	if (bRequireSameParentClass && FingerprintA.CppParentClassPath != FingerprintB.CppParentClassPath)
+	{
+		return 0.0f;
+	}
+
+	if (!FingerprintA.bValid || !FingerprintB.bValid)
+	{
+		return 0.0f;
+	}
+
+	TMap<FName, const FReflectionPropertyFingerprint*> PropertiesMapB;
+	PropertiesMapB.Reserve(FingerprintB.Properties.Num());
+	for (const FReflectionPropertyFingerprint& PropertyB : FingerprintB.Properties)
+	{
+		PropertiesMapB.Add(PropertyB.PropertyName, &PropertyB);
 	}
 
 	int32 TotalPropertiesInB = PropertiesMapB.Num();
@@ -336,76 +359,27 @@ float UReflectionVariableDeduplication::CompareObjectsByReflection(UObject* Obje
 	int32 StructureDifference = 0;
 	int32 TotalPropertiesInA = 0;
 
-	for (TFieldIterator<FProperty> PropertyIterator(ClassA); PropertyIterator; ++PropertyIterator)
+	for (const FReflectionPropertyFingerprint& PropertyA : FingerprintA.Properties)
 	{
-		FProperty* PropertyA = *PropertyIterator;
-		if (PropertyA == nullptr)
-		{
-			continue;
-		}
-
-		if (bCompareOnlyVisibleProperties)
-		{
-			if (PropertyA->HasAnyPropertyFlags(CPF_DisableEditOnInstance))
-			{
-				continue;
-			}
-		}
-
-		if (bIgnoreTransientProperties)
-		{
-			if (PropertyA->HasAnyPropertyFlags(CPF_Transient))
-			{
-				continue;
-			}
-		}
-
-		if (bIgnoreEditDefaultsOnlyProperties)
-		{
-			if (PropertyA->HasAnyPropertyFlags(CPF_DisableEditOnInstance) && !PropertyA->HasAnyPropertyFlags(CPF_Edit))
-			{
-				continue;
-			}
-		}
-
-		if (!PropertyA->HasAnyPropertyFlags(CPF_Edit | CPF_BlueprintVisible))
-		{
-			continue;
-		}
-
 		TotalPropertiesInA++;
 
-		FProperty** PropertyBFound = PropertiesMapB.Find(PropertyA->GetFName());
+		const FReflectionPropertyFingerprint** PropertyBFound = PropertiesMapB.Find(PropertyA.PropertyName);
 		if (PropertyBFound == nullptr)
 		{
 			StructureDifference++;
 			continue;
 		}
 
-		FProperty* PropertyB = *PropertyBFound;
-		if (PropertyB == nullptr)
-		{
-			StructureDifference++;
-			PropertiesMapB.Remove(PropertyA->GetFName());
-			continue;
-		}
-
-		FString SignatureA = GetPropertySignature(PropertyA);
-		FString SignatureB = GetPropertySignature(PropertyB);
+		const FReflectionPropertyFingerprint* PropertyB = *PropertyBFound;
+		PropertiesMapB.Remove(PropertyA.PropertyName);
 
-		if (SignatureA != SignatureB)
+		if (PropertyA.Signature != PropertyB->Signature)
 		{
 			StructureDifference++;
-			PropertiesMapB.Remove(PropertyA->GetFName());
 			continue;
 		}
 
-		const void* ValueA = PropertyA->ContainerPtrToValuePtr<void>(DefaultObjectA);
-		const void* ValueB = PropertyB->ContainerPtrToValuePtr<void>(DefaultObjectB);
-
-		PropertiesMapB.Remove(PropertyA->GetFName());
-
-		if (ArePropertyValuesEqual(PropertyA, ValueA, ValueB))
+		if (PropertyA.Value == PropertyB->Value)
 		{
 			MatchingProperties++;
 		}
@@ -445,25 +419,6 @@ FString UReflectionVariableDeduplication::GetPropertySignature(const FProperty*
 	return FString::Format(TEXT("{0}:{1}"), { PropertyName, PropertyType });
 }
 
-bool UReflectionVariableDeduplication::ArePropertyValuesEqual(const FProperty* Property, const void* ValueA, const void* ValueB) const
-{
-	if (Property == nullptr || ValueA == nullptr || ValueB == nullptr)
-	{
-		return false;
-	}
-
-	FString TextA;
-	FString TextB;
-
-	const uint8* DataA = static_cast<const uint8*>(ValueA);
-	const uint8* DataB = static_cast<const uint8*>(ValueB);
-
-	Property->ExportTextItem_Direct(TextA, DataA, DataA, nullptr, PPF_None, nullptr);
-	Property->ExportTextItem_Direct(TextB, DataB, DataB, nullptr, PPF_None, nullptr);
-
-	return TextA == TextB;
-}
-
 UClass* UReflectionVariableDeduplication::GetRealClass(UObject* Object) const
 {
 	if (Object == nullptr)
@@ -8,10 +8,533 @@
 #include "DeduplicateObjects/TextureSSIMDeduplication.h"
 #include "AssetRegistry/AssetData.h"
 #include "Engine/Texture.h"
-#include "Rendering/Texture2DResource.h"
 #include "Misc/ScopeLock.h"
 #include "HAL/PlatformProcess.h"
 #include "Engine/Texture.h"
+#include "DeduplicationFingerprintCache.h"
+#include "DeduplicationSimdKernels.h"
+#include "Algo/Sort.h"
+#include "ImageCore.h"
+#include "Math/Float16.h"
+
+namespace TextureSSIMDeduplication
+{
+    // Luminance at the working resolution stored with 16-bit precision, together with the resolution of the source
+    struct FCachedGray
+    {
+        int32 Width = 0;
+        int32 Height = 0;
+        int32 SourceWidth = 0;
+        int32 SourceHeight = 0;
+        TArray<uint16> Gray;
+
+        friend FArchive& operator<<(FArchive& Ar, FCachedGray& Cached)
+        {
+            Ar << Cached.Width;
+            Ar << Cached.Height;
+            Ar << Cached.SourceWidth;
+            Ar << Cached.SourceHeight;
+            Ar << Cached.Gray;
+            return Ar;
+        }
+    };
+
+    // Buffers of ComputeSSIM, only ever grown while a run reuses them, so comparing pairs allocates nothing once warmed up.
+    struct FSSIMScratch
+    {
+        TArray<float> Kernel;
+        int32 KernelRadius = INDEX_NONE;
+        TArray<float> Temp;
+        TArray<float> Product;
+        TArray<float> MuA;
+        TArray<float> MuB;
+        TArray<float> MuAA;
+        TArray<float> MuBB;
+        TArray<float> MuAB;
+        TArray<float> WideA;
+        TArray<float> WideB;
+        TArray<double> Sums;
+
+        void Reserve(int32 PixelCount)
+        {
+            for (TArray<float>* Buffer : { &Temp, &Product, &MuA, &MuB, &MuAA, &MuBB, &MuAB, &WideA, &WideB })
+            {
+                if (Buffer->Num() < PixelCount)
+                {
+                    Buffer->SetNumUninitialized(PixelCount);
+                }
+            }
+        }
+    };
+
+    static void QuantizeLuminance(const TArray<float>& Gray, TArray<uint16>& OutQuantized)
+    {
+        OutQuantized.SetNumUninitialized(Gray.Num());
+        for (int32 Index = 0; Index < Gray.Num(); ++Index)
+        {
+            OutQuantized[Index] = static_cast<uint16>(FMath::RoundToInt(FMath::Clamp(Gray[Index], 0.0f, 1.0f) * 65535.0f));
+        }
+    }
+
+    static void WidenLuminance(const uint16* Quantized, int32 Num, float* OutGray)
+    {
+        for (int32 Index = 0; Index < Num; ++Index)
+        {
+            OutGray[Index] = static_cast<float>(Quantized[Index]) / 65535.0f;
+        }
+    }
+
+    // Separable blur with clamped borders. The vertical pass accumulates whole rows, so it streams through memory instead of walking
+    // columns, and adds the taps in the same order as a per-pixel loop would.
+    static void GaussianBlur(const float* In, float* Out, float* Temp, int32 Width, int32 Height, const float* Kernel, int32 Radius)
+    {
+        for (int32 Y = 0; Y < Height; ++Y)
+        {
+            const float* InRow = In + int64(Y) * Width;
+            float* TempRow = Temp + int64(Y) * Width;
+            for (int32 X = 0; X < Width; ++X)
+            {
+                float Sum = 0.0f;
+                if (X >= Radius && X + Radius < Width)
+                {
+                    const float* Source = InRow + X - Radius;
+                    for (int32 K = 0; K <= 2 * Radius; ++K)
+                    {
+                        Sum += Kernel[K] * Source[K];
+                    }
+                }
+                else
+                {
+                    for (int32 K = -Radius; K <= Radius; ++K)
+                    {
+                        Sum += Kernel[K + Radius] * InRow[FMath::Clamp(X + K, 0, Width - 1)];
+                    }
+                }
+                TempRow[X] = Sum;
+            }
+        }
+
+        for (int32 Y = 0; Y < Height; ++Y)
+        {
+            float* OutRow = Out + int64(Y) * Width;
+            FMemory::Memzero(OutRow, Width * sizeof(float));
+            for (int32 K = -Radius; K <= Radius; ++K)
+            {
+                const float Weight = Kernel[K + Radius];
+                const float* TempRow = Temp + int64(FMath::Clamp(Y + K, 0, Height - 1)) * Width;
+                for (int32 X = 0; X < Width; ++X)
+                {
+                    OutRow[X] += Weight * TempRow[X];
+                }
+            }
+        }
+    }
+
+    // Local means over a box window clipped to the image, from integral images of A, B, A*A, B*B and A*B kept in double.
+    static void BoxMeans(const float* A, const float* B, int32 Width, int32 Height, int32 Radius, FSSIMScratch& Scratch)
+    {
+        const int32 Stride = Width + 1;
+        const int64 TableSize = int64(Stride) * (Height + 1);
+        Scratch.Sums.SetNumUninitialized(TableSize * 5, EAllowShrinking::No);
+        double* Tables[5];
+        for (int32 Table = 0; Table < 5; ++Table)
+        {
+            Tables[Table] = Scratch.Sums.GetData() + Table * TableSize;
+            FMemory::Memzero(Tables[Table], Stride * sizeof(double));
+        }
+
+        for (int32 Y = 0; Y < Height; ++Y)
+        {
+            double RowSums[5] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+            const int64 Above = int64(Y) * Stride;
+            const int64 Current = Above + Stride;
+            for (int32 Table = 0; Table < 5; ++Table)
+            {
+                Tables[Table][Current] = 0.0;
+            }
+            for (int32 X = 0; X < Width; ++X)
+            {
+                const double ValueA = A[int64(Y) * Width + X];
+                const double ValueB = B[int64(Y) * Width + X];
+                const double Values[5] = { ValueA, ValueB, ValueA * ValueA, ValueB * ValueB, ValueA * ValueB };
+                for (int32 Table = 0; Table < 5; ++Table)
+                {
+                    RowSums[Table] += Values[Table];
+                    Tables[Table][Current + X + 1] = Tables[Table][Above + X + 1] + RowSums[Table];
+                }
+            }
+        }
+
+        float* Means[5] = { Scratch.MuA.GetData(), Scratch.MuB.GetData(), Scratch.MuAA.GetData(), Scratch.MuBB.GetData(), Scratch.MuAB.GetData() };
+        for (int32 Y = 0; Y < Height; ++Y)
+        {
+            const int32 Top = FMath::Max(Y - Radius, 0);
+            const int32 Bottom = FMath::Min(Y + Radius + 1, Height);
+            for (int32 X = 0; X < Width; ++X)
+            {
+                const int32 Left = FMath::Max(X - Radius, 0);
+                const int32 Right = FMath::Min(X + Radius + 1, Width);
+                const double InvCount = 1.0 / double((Bottom - Top) * (Right - Left));
+                for (int32 Table = 0; Table < 5; ++Table)
+                {
+                    const double* Sum = Tables[Table];
+                    const double BoxSum = Sum[int64(Bottom) * Stride + Right] - Sum[int64(Top) * Stride + Right] - Sum[int64(Bottom) * Stride + Left] + Sum[int64(Top) * Stride + Left];
+                    Means[Table][int64(Y) * Width + X] = float(BoxSum * InvCount);
+                }
+            }
+        }
+    }
+
+    static float Rec601Luminance(float R, float G, float B)
+    {
+        return FMath::Clamp(0.299f * R + 0.587f * G + 0.114f * B, 0.0f, 1.0f);
+    }
+
+    static float ReadHalf(const uint8* Pixel, int32 Channel)
+    {
+        return reinterpret_cast<const FFloat16*>(Pixel)[Channel].GetFloat();
+    }
+
+    // Luminance of one pixel for every raw image format a texture source decodes to. Values stay in the gamma space they are stored in;
+    // float formats are clamped to [0, 1].
+    struct FGrayConversion
+    {
+        ERawImageFormat::Type Format;
+        int32 BytesPerPixel;
+        float (*Luminance)(const uint8* Pixel);
+    };
+
+    static const FGrayConversion GrayConversions[] =
+    {
+        { ERawImageFormat::G8, 1, [](const uint8* Pixel) { return Pixel[0] / 255.0f; } },
+        { ERawImageFormat::BGRA8, 4, [](const uint8* Pixel) { return Rec601Luminance(Pixel[2] / 255.0f, Pixel[1] / 255.0f, Pixel[0] / 255.0f); } },
+        { ERawImageFormat::G16, 2, [](const uint8* Pixel) { return reinterpret_cast<const uint16*>(Pixel)[0] / 65535.0f; } },
+        { ERawImageFormat::RGBA16, 8, [](const uint8* Pixel)
+            {
+                const uint16* Channels = reinterpret_cast<const uint16*>(Pixel);
+                return Rec601Luminance(Channels[0] / 65535.0f, Channels[1] / 65535.0f, Channels[2] / 65535.0f);
+            } },
+        { ERawImageFormat::R16F, 2, [](const uint8* Pixel) { return FMath::Clamp(ReadHalf(Pixel, 0), 0.0f, 1.0f); } },
+        { ERawImageFormat::RGBA16F, 8, [](const uint8* Pixel) { return Rec601Luminance(ReadHalf(Pixel, 0), ReadHalf(Pixel, 1), ReadHalf(Pixel, 2)); } },
+        { ERawImageFormat::R32F, 4, [](const uint8* Pixel) { return FMath::Clamp(reinterpret_cast<const float*>(Pixel)[0], 0.0f, 1.0f); } },
+        { ERawImageFormat::RGBA32F, 16, [](const uint8* Pixel)
+            {
+                const float* Channels = reinterpret_cast<const float*>(Pixel);
+                return Rec601Luminance(Channels[0], Channels[1], Channels[2]);
+            } },
+    };
+
+    // Formats without a table entry (shared exponent and the like) are converted to linear RGBA32F by ImageCore first.
+    static bool ConvertImageToGray(const FImage& Image, TArray<float>& OutGray)
+    {
+        const FGrayConversion* Conversion = nullptr;
+        for (const FGrayConversion& Candidate : GrayConversions)
+        {
+            if (Candidate.Format == Image.Format)
+            {
+                Conversion = &Candidate;
+                break;
+            }
+        }
+
+        if (Conversion == nullptr)
+        {
+            FImage Converted;
+            Image.CopyTo(Converted, ERawImageFormat::RGBA32F, EGammaSpace::Linear);
+            return Converted.Format == ERawImageFormat::RGBA32F && ConvertImageToGray(Converted, OutGray);
+        }
+
+        const int64 PixelCount = int64(Image.SizeX) * Image.SizeY;
+        if (PixelCount <= 0 || Image.RawData.Num() < PixelCount * Conversion->BytesPerPixel)
+        {
+            return false;
+        }
+
+        OutGray.SetNumUninitialized(PixelCount);
+        const uint8* Pixel = Image.RawData.GetData();
+        for (int64 Index = 0; Index < PixelCount; ++Index, Pixel += Conversion->BytesPerPixel)
+        {
+            OutGray[Index] = Conversion->Luminance(Pixel);
+        }
+        return true;
+    }
+
+    static float Lanczos3(float X)
+    {
+        X = FMath::Abs(X);
+        if (X < UE_SMALL_NUMBER)
+        {
+            return 1.0f;
+        }
+        if (X >= 3.0f)
+        {
+            return 0.0f;
+        }
+        const float PiX = PI * X;
+        return 3.0f * FMath::Sin(PiX) * FMath::Sin(PiX / 3.0f) / (PiX * PiX);
+    }
+
+    // Lanczos-3 taps of a 1D resize with clamped borders. When shrinking the kernel is widened by the scale factor, so it also acts
+    // as the anti-aliasing filter. Every output sample gets NumTaps (index, weight) pairs.
+    static void ComputeResizeTaps(int32 InSize, int32 OutSize, int32& OutNumTaps, TArray<int32>& OutIndices, TArray<float>& OutWeights)
+    {
+        const float Scale = float(OutSize) / float(InSize);
+        const float FilterScale = FMath::Min(Scale, 1.0f);
+        const float Support = 3.0f / FilterScale;
+        OutNumTaps = FMath::CeilToInt(Support) * 2 + 1;
+        OutIndices.SetNumUninitialized(OutSize * OutNumTaps);
+        OutWeights.SetNumUninitialized(OutSize * OutNumTaps);
+
+        for (int32 Out = 0; Out < OutSize; ++Out)
+        {
+            const float Center = (Out + 0.5f) / Scale - 0.5f;
+            const int32 First = FMath::FloorToInt(Center) - OutNumTaps / 2;
+            float WeightSum = 0.0f;
+            for (int32 Tap = 0; Tap < OutNumTaps; ++Tap)
+            {
+                const int32 In = First + Tap;
+                const float Weight = Lanczos3((In - Center) * FilterScale);
+                OutIndices[Out * OutNumTaps + Tap] = FMath::Clamp(In, 0, InSize - 1);
+                OutWeights[Out * OutNumTaps + Tap] = Weight;
+                WeightSum += Weight;
+            }
+            for (int32 Tap = 0; Tap < OutNumTaps; ++Tap)
+            {
+                OutWeights[Out * OutNumTaps + Tap] /= WeightSum;
+            }
+        }
+    }
+
+    // Separable Lanczos-3 resize, rows first and then whole rows accumulated for the vertical pass.
+    static void Resize(const TArray<float>& In, int32 InWidth, int32 InHeight, TArray<float>& Out, int32 OutWidth, int32 OutHeight)
+    {
+        int32 NumTapsX = 0, NumTapsY = 0;
+        TArray<int32> IndicesX, IndicesY;
+        TArray<float> WeightsX, WeightsY;
+        ComputeResizeTaps(InWidth, OutWidth, NumTapsX, IndicesX, WeightsX);
+        ComputeResizeTaps(InHeight, OutHeight, NumTapsY, IndicesY, WeightsY);
+
+        TArray<float> Temp;
+        Temp.SetNumUninitialized(OutWidth * InHeight);
+        for (int32 Y = 0; Y < InHeight; ++Y)
+        {
+            const float* InRow = In.GetData() + int64(Y) * InWidth;
+            for (int32 X = 0; X < OutWidth; ++X)
+            {
+                float Sum = 0.0f;
+                for (int32 Tap = 0; Tap < NumTapsX; ++Tap)
+                {
+                    Sum += WeightsX[X * NumTapsX + Tap] * InRow[IndicesX[X * NumTapsX + Tap]];
+                }
+                Temp[int64(Y) * OutWidth + X] = Sum;
+            }
+        }
+
+        Out.SetNumZeroed(OutWidth * OutHeight);
+        for (int32 Y = 0; Y < OutHeight; ++Y)
+        {
+            float* OutRow = Out.GetData() + int64(Y) * OutWidth;
+            for (int32 Tap = 0; Tap < NumTapsY; ++Tap)
+            {
+                const float Weight = WeightsY[Y * NumTapsY + Tap];
+                const float* TempRow = Temp.GetData() + int64(IndicesY[Y * NumTapsY + Tap]) * OutWidth;
+                for (int32 X = 0; X < OutWidth; ++X)
+                {
+                    OutRow[X] += Weight * TempRow[X];
+                }
+            }
+            // Lanczos rings slightly around edges.
+            for (int32 X = 0; X < OutWidth; ++X)
+            {
+                OutRow[X] = FMath::Clamp(OutRow[X], 0.0f, 1.0f);
+            }
+        }
+    }
+
+    static constexpr int32 HashImageSize = 32;
+    static constexpr int32 HashCoefficients = 8;
+    // Largest AC coefficient of a flat texture, relative to the DC sum of the 32x32 hash image
+    static constexpr float FlatEnergyEpsilon = 1e-3f;
+
+    // DCT-II basis of a HashImageSize point transform, Basis[Frequency][Position].
+    struct FHashDctBasis
+    {
+        float Basis[HashImageSize][HashImageSize];
+
+        FHashDctBasis()
+        {
+            for (int32 Frequency = 0; Frequency < HashImageSize; ++Frequency)
+            {
+                for (int32 Position = 0; Position < HashImageSize; ++Position)
+                {
+                    Basis[Frequency][Position] = FMath::Cos(PI * Frequency * (2 * Position + 1) / (2.0f * HashImageSize));
+                }
+            }
+        }
+    };
+
+    // pHash: the luminance is box-filtered to 32x32, the lowest 8x8 DCT frequencies above DC are thresholded at their median.
+    // Flat textures get a zero hash and bOutFlat, their median split would only sort rounding noise.
+    static uint64 ComputePerceptualHash(const TArray<float>& Gray, int32 Width, int32 Height, bool& bOutFlat)
+    {
+        static const FHashDctBasis Dct;
+
+        float Image[HashImageSize][HashImageSize];
+        float Mean = 0.0f;
+        for (int32 Y = 0; Y < HashImageSize; ++Y)
+        {
+            const int32 BeginY = Y * Height / HashImageSize;
+            const int32 EndY = FMath::Max(BeginY + 1, (Y + 1) * Height / HashImageSize);
+            for (int32 X = 0; X < HashImageSize; ++X)
+            {
+                const int32 BeginX = X * Width / HashImageSize;
+                const int32 EndX = FMath::Max(BeginX + 1, (X + 1) * Width / HashImageSize);
+                float Sum = 0.0f;
+                for (int32 SY = BeginY; SY < EndY; ++SY)
+                {
+                    for (int32 SX = BeginX; SX < EndX; ++SX)
+                    {
+                        Sum += Gray[SY * Width + SX];
+                    }
+                }
+                Image[Y][X] = Sum / float((EndY - BeginY) * (EndX - BeginX));
+                Mean += Image[Y][X];
+            }
+        }
+        Mean /= float(HashImageSize * HashImageSize);
+
+        // Rows first, only for the frequencies that end up in the hash.
+        float RowTransform[HashImageSize][HashCoefficients];
+        for (int32 Y = 0; Y < HashImageSize; ++Y)
+        {
+            for (int32 V = 0; V < HashCoefficients; ++V)
+            {
+                float Sum = 0.0f;
+                for (int32 X = 0; X < HashImageSize; ++X)
+                {
+                    Sum += Image[Y][X] * Dct.Basis[V + 1][X];
+                }
+                RowTransform[Y][V] = Sum;
+            }
+        }
+
+        float Coefficients[HashCoefficients * HashCoefficients];
+        for (int32 U = 0; U < HashCoefficients; ++U)
+        {
+            for (int32 V = 0; V < HashCoefficients; ++V)
+            {
+                float Sum = 0.0f;
+                for (int32 Y = 0; Y < HashImageSize; ++Y)
+                {
+                    Sum += Dct.Basis[U + 1][Y] * RowTransform[Y][V];
+                }
+                Coefficients[U * HashCoefficients + V] = Sum;
+            }
+        }
+
+        // Black textures are held to the epsilon of one 8-bit step rather than to exactly zero.
+        float MaxCoefficient = 0.0f;
+        for (const float Coefficient : Coefficients)
+        {
+            MaxCoefficient = FMath::Max(MaxCoefficient, FMath::Abs(Coefficient));
+        }
+        bOutFlat = MaxCoefficient <= FlatEnergyEpsilon * float(HashImageSize * HashImageSize) * FMath::Max(Mean, 1.0f / 255.0f);
+        if (bOutFlat)
+        {
+            return 0;
+        }
+
+        float Sorted[HashCoefficients * HashCoefficients];
+        FMemory::Memcpy(Sorted, Coefficients, sizeof(Sorted));
+        Algo::Sort(Sorted);
+        const int32 Middle = HashCoefficients * HashCoefficients / 2;
+        const float Median = 0.5f * (Sorted[Middle - 1] + Sorted[Middle]);
+
+        uint64 Hash = 0;
+        for (int32 Index = 0; Index < HashCoefficients * HashCoefficients; ++Index)
+        {
+            if (Coefficients[Index] > Median)
+            {
+                Hash |= 1ull << Index;
+            }
+        }
+        return Hash;
+    }
+
+    // Multi-index hashing: the hash is cut into Radius + 1 chunks, two hashes within Radius bits agree on at least one chunk.
+    // Only pairs sharing a chunk value are checked for their full Hamming distance.
+    // Flat textures are left out of the index and form one bucket of their own, every pair in it is a candidate.
+    static void GeneratePerceptualHashCandidates(TArrayView<const uint64> Hashes, TArrayView<const bool> Flat, int32 Radius, TFunctionRef<bool()> ShouldStop, TArray<TPair<int32, int32>>& OutCandidatePairs)
+    {
+        const int32 NumHashes = Hashes.Num();
+        // Callers handle Radius >= 64, where no chunking can keep the pigeonhole guarantee.
+        const int32 NumChunks = FMath::Clamp(Radius + 1, 1, 64);
+
+        TArray<int32> FlatIndices;
+        for (int32 Index = 0; Index < NumHashes; ++Index)
+        {
+            if (Flat[Index])
+            {
+                FlatIndices.Add(Index);
+            }
+        }
+        for (int32 MemberA = 0; MemberA < FlatIndices.Num() - 1; ++MemberA)
+        {
+            for (int32 MemberB = MemberA + 1; MemberB < FlatIndices.Num(); ++MemberB)
+            {
+                OutCandidatePairs.Emplace(FlatIndices[MemberA], FlatIndices[MemberB]);
+            }
+        }
+
+        TSet<uint64> CandidateKeys;
+        TMap<uint64, TArray<int32>> Buckets;
+        for (int32 Chunk = 0; Chunk < NumChunks; ++Chunk)
+        {
+            if (ShouldStop())
+            {
+                return;
+            }
+
+            const int32 BeginBit = Chunk * 64 / NumChunks;
+            const int32 EndBit = (Chunk + 1) * 64 / NumChunks;
+            const uint64 ChunkMask = (EndBit - BeginBit) >= 64 ? ~0ull : ((1ull << (EndBit - BeginBit)) - 1) << BeginBit;
+
+            Buckets.Reset();
+            for (int32 Index = 0; Index < NumHashes; ++Index)
+            {
+                if (!Flat[Index])
+                {
+                    Buckets.FindOrAdd(Hashes[Index] & ChunkMask).Add(Index);
+                }
+            }
+
+            for (const TPair<uint64, TArray<int32>>& Bucket : Buckets)
+            {
+                const TArray<int32>& Members = Bucket.Value;
+                for (int32 MemberA = 0; MemberA < Members.Num() - 1; ++MemberA)
+                {
+                    for (int32 MemberB = MemberA + 1; MemberB < Members.Num(); ++MemberB)
+                    {
+                        const int32 IndexA = Members[MemberA];
+                        const int32 IndexB = Members[MemberB];
+                        if (static_cast<int32>(FMath::CountBits(Hashes[IndexA] ^ Hashes[IndexB])) > Radius)
+                        {
+                            continue;
+                        }
+
+                        bool bAlreadyAdded = false;
+                        CandidateKeys.Add((static_cast<uint64>(IndexA) << 32) | static_cast<uint32>(IndexB), &bAlreadyAdded);
+                        if (!bAlreadyAdded)
+                        {
+                            OutCandidatePairs.Emplace(IndexA, IndexB);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
 UTextureSSIMDeduplication::UTextureSSIMDeduplication()
 {
     SimilarityThreshold = 0.7f;
@@ -33,8 +556,39 @@ float UTextureSSIMDeduplication::CalculateComplexity_Implementation(const TArray
     return CheckAssets.Num();
 }
 
+bool UTextureSSIMDeduplication::IsAssetFeatureCached(const FAssetData& Asset) const
+{
+    return bUseFingerprintCache && FDeduplicationFingerprintCache::Get().HasFeature(Asset, GetCachedGrayName());
+}
+
+FName UTextureSSIMDeduplication::GetCachedGrayName() const
+{
+    // v3: luminance is decoded from source mips, v2 entries were read from compressed platform data.
+    return FName(*FString::Printf(TEXT("TextureSSIM.Gray.v3.%d"), FMath::Clamp(MaxWorkingResolution, 16, 4096)));
+}
+
 bool UTextureSSIMDeduplication::LoadTextureGrayFromAsset(const FAssetData& Asset, FLoadedTexture& OutTexture)
 {
+    using namespace TextureSSIMDeduplication;
+
+    const FName CachedGrayName = GetCachedGrayName();
+    if (bUseFingerprintCache)
+    {
+        FCachedGray Cached;
+        if (FDeduplicationFingerprintCache::Get().FindFeature(Asset, CachedGrayName, Cached)
+            && Cached.Width > 0 && Cached.Height > 0 && Cached.Gray.Num() == Cached.Width * Cached.Height)
+        {
+            OutTexture.Width = Cached.Width;
+            OutTexture.Height = Cached.Height;
+            OutTexture.SourceWidth = Cached.SourceWidth;
+            OutTexture.SourceHeight = Cached.SourceHeight;
+            OutTexture.Gray.SetNumUninitialized(Cached.Gray.Num());
+            WidenLuminance(Cached.Gray.GetData(), Cached.Gray.Num(), OutTexture.Gray.GetData());
+            OutTexture.bValid = true;
+            return true;
+        }
+    }
+
     UObject* Loaded = Asset.GetAsset();
     UTexture2D* Texture = Cast<UTexture2D>(Loaded);
     if (!Texture)
@@ -42,107 +596,181 @@ bool UTextureSSIMDeduplication::LoadTextureGrayFromAsset(const FAssetData& Asset
         return false;
     }
 
-    return ExtractGrayFromTexture(Texture, OutTexture);
+    if (!ExtractGrayFromTexture(Texture, OutTexture))
+    {
+        return false;
+    }
+
+    ReduceToWorkingResolution(OutTexture);
+
+    if (bUseFingerprintCache)
+    {
+        FCachedGray Cached;
+        Cached.Width = OutTexture.Width;
+        Cached.Height = OutTexture.Height;
+        Cached.SourceWidth = OutTexture.SourceWidth;
+        Cached.SourceHeight = OutTexture.SourceHeight;
+        QuantizeLuminance(OutTexture.Gray, Cached.Gray);
+        FDeduplicationFingerprintCache::Get().StoreFeature(Asset, CachedGrayName, Cached);
+    }
+
+    return true;
 }
 
 bool UTextureSSIMDeduplication::ExtractGrayFromTexture(UTexture2D* Texture, FLoadedTexture& OutTexture)
 {
-    FEvent* WaitEvent = FPlatformProcess::GetSynchEventFromPool(true);
-
-    AsyncTask(ENamedThreads::GameThread, [Texture, &OutTexture, WaitEvent]()
-        {
-            bool bSucceeded = false;
+#if WITH_EDITOR
+    // The source is read through its editor bulk data, which is safe on worker threads, so neither the render resource nor the
+    // compressed platform data is touched.
+    if (!Texture || !Texture->Source.IsValid())
+    {
+        return false;
+    }
 
-            if (!Texture)
-            {
-                WaitEvent->Trigger();
-                return;
-            }
+    FTextureSource& Source = Texture->Source;
+    const int32 SourceWidth = Source.GetSizeX();
+    const int32 SourceHeight = Source.GetSizeY();
+    if (SourceWidth <= 0 || SourceHeight <= 0)
+    {
+        return false;
+    }
 
-            Texture->UpdateResourceWithParams(UTexture::EUpdateResourceFlags::Synchronous);
+    const int32 MaxResolution = FMath::Clamp(MaxWorkingResolution, 16, 4096);
+    int32 MipIndex = 0;
+    while (MipIndex + 1 < Source.GetNumMips()
+        && FMath::Max(SourceWidth >> (MipIndex + 1), SourceHeight >> (MipIndex + 1)) >= MaxResolution)
+    {
+        ++MipIndex;
+    }
 
-            FTexturePlatformData* PlatformData = Texture->GetPlatformData();
-            if (!PlatformData || PlatformData->Mips.Num() == 0)
-            {
-                WaitEvent->Trigger();
-                return;
-            }
+    FImage Image;
+    if (!Source.GetMipImage(Image, 0, 0, MipIndex) || !TextureSSIMDeduplication::ConvertImageToGray(Image, OutTexture.Gray))
+    {
+        return false;
+    }
 
-            const int32 Width = Texture->Source.GetSizeX();
-            const int32 Height = Texture->Source.GetSizeY();
-            if (Width <= 0 || Height <= 0)
-            {
-                WaitEvent->Trigger();
-                return;
-            }
+    OutTexture.Width = Image.SizeX;
+    OutTexture.Height = Image.SizeY;
+    OutTexture.SourceWidth = SourceWidth;
+    OutTexture.SourceHeight = SourceHeight;
+    OutTexture.bValid = true;
+    return true;
+#else
+    return false;
+#endif
+}
 
-            const int32 PixelCount = Width * Height;
 
-            OutTexture.Gray.Reset();
-            OutTexture.Gray.SetNumUninitialized(PixelCount);
-            OutTexture.Width = Width;
-            OutTexture.Height = Height;
-            OutTexture.bValid = false;
 
-            const int32 BytesPerPixel = Texture->Source.GetBytesPerPixel();
+void UTextureSSIMDeduplication::ReduceToWorkingResolution(FLoadedTexture& Texture) const
+{
+    const int32 MaxResolution = FMath::Clamp(MaxWorkingResolution, 16, 4096);
+    while (Texture.Width > MaxResolution || Texture.Height > MaxResolution)
+    {
+        TArray<float> Down;
+        int32 OutW = 0, OutH = 0;
+        Downsample2x(Texture.Gray, Down, Texture.Width, Texture.Height, OutW, OutH);
+        Texture.Gray = MoveTemp(Down);
+        Texture.Width = OutW;
+        Texture.Height = OutH;
+    }
+}
 
-            FTexture2DMipMap& Mip = PlatformData->Mips[0];
-            const int64 BulkSize = Mip.BulkData.GetBulkDataSize();
-            if (BulkSize <= 0)
-            {
-                WaitEvent->Trigger();
-                return;
-            }
+void UTextureSSIMDeduplication::BuildPyramid(const FLoadedTexture& Texture, FLuminancePyramid& OutPyramid) const
+{
+    OutPyramid.SourceWidth = Texture.SourceWidth;
+    OutPyramid.SourceHeight = Texture.SourceHeight;
+    OutPyramid.Levels.Reset();
+    OutPyramid.LevelSizes.Reset();
+
+    // The working resolution is reached by halving, a final resize lands on the comparison resolution of the aspect ratio.
+    int32 ComparisonWidth = Texture.Width;
+    int32 ComparisonHeight = Texture.Height;
+    if (bMatchAcrossResolutions)
+    {
+        GetComparisonSize(Texture.SourceWidth, Texture.SourceHeight, ComparisonWidth, ComparisonHeight);
+    }
 
-            const void* RawData = Mip.BulkData.LockReadOnly();
-            if (!RawData)
-            {
-                // �� �������� Unlock, ���� LockReadOnly ������ nullptr
-                WaitEvent->Trigger();
-                return;
-            }
+    // Levels are built from the full precision luminance of the previous level and only quantized for storage.
+    TArray<float> Current;
+    if (ComparisonWidth != Texture.Width || ComparisonHeight != Texture.Height)
+    {
+        TextureSSIMDeduplication::Resize(Texture.Gray, Texture.Width, Texture.Height, Current, ComparisonWidth, ComparisonHeight);
+    }
+    else
+    {
+        Current = Texture.Gray;
+    }
+    TextureSSIMDeduplication::QuantizeLuminance(Current, OutPyramid.Levels.AddDefaulted_GetRef());
+    OutPyramid.LevelSizes.Emplace(ComparisonWidth, ComparisonHeight);
+    OutPyramid.PerceptualHash = TextureSSIMDeduplication::ComputePerceptualHash(Texture.Gray, Texture.Width, Texture.Height, OutPyramid.bFlat);
 
-            const uint8* BytePtr = static_cast<const uint8*>(RawData);
+    // Scales below 2x2 are not compared, the same cut-off ComputeMSSSIM has always used
+    for (int32 Level = 1; Level < MSSSIMLevels; ++Level)
+    {
+        const FIntPoint PreviousSize = OutPyramid.LevelSizes.Last();
+        TArray<float> Down;
+        int32 OutW = 0, OutH = 0;
+        Downsample2x(Current, Down, PreviousSize.X, PreviousSize.Y, OutW, OutH);
+        if (OutW <= 1 || OutH <= 1)
+        {
+            break;
+        }
+        Current = MoveTemp(Down);
+        TextureSSIMDeduplication::QuantizeLuminance(Current, OutPyramid.Levels.AddDefaulted_GetRef());
+        OutPyramid.LevelSizes.Emplace(OutW, OutH);
+    }
+}
 
-            if (BytesPerPixel == 1)
-            {
-                for (int32 Index = 0; Index < PixelCount; ++Index)
-                {
-                    const uint8 GrayByte = BytePtr[Index];
-                    const float L = static_cast<float>(GrayByte) / 255.0f;
-                    OutTexture.Gray[Index] = FMath::Clamp(L, 0.0f, 1.0f);
-                }
-            }
-            else
-            {
-                for (int32 Index = 0, Offset = 0; Index < PixelCount; ++Index, Offset += BytesPerPixel)
-                {
-                    uint8 R = BytePtr[Offset + 0];
-                    uint8 G = (BytesPerPixel >= 2) ? BytePtr[Offset + 1] : R;
-                    uint8 B = (BytesPerPixel >= 3) ? BytePtr[Offset + 2] : R;
+void UTextureSSIMDeduplication::GetComparisonSize(int32 SourceWidth, int32 SourceHeight, int32& OutWidth, int32& OutHeight) const
+{
+    const int32 MaxResolution = FMath::Clamp(MaxWorkingResolution, 16, 4096);
+    if (SourceWidth >= SourceHeight)
+    {
+        OutWidth = MaxResolution;
+        OutHeight = FMath::Max(1, FMath::RoundToInt(float(MaxResolution) * SourceHeight / float(SourceWidth)));
+    }
+    else
+    {
+        OutHeight = MaxResolution;
+        OutWidth = FMath::Max(1, FMath::RoundToInt(float(MaxResolution) * SourceWidth / float(SourceHeight)));
+    }
+}
 
-                    const float FR = static_cast<float>(R) / 255.0f;
-                    const float FG = static_cast<float>(G) / 255.0f;
-                    const float FB = static_cast<float>(B) / 255.0f;
+bool UTextureSSIMDeduplication::CanCompare(const FLuminancePyramid& A, const FLuminancePyramid& B) const
+{
+    if (bMatchAcrossResolutions)
+    {
+        return A.LevelSizes == B.LevelSizes;
+    }
+    return A.SourceWidth == B.SourceWidth && A.SourceHeight == B.SourceHeight;
+}
 
-                    const float L = 0.299f * FR + 0.587f * FG + 0.114f * FB;
-                    OutTexture.Gray[Index] = FMath::Clamp(L, 0.0f, 1.0f);
-                }
-            }
+UTextureSSIMDeduplication::FLuminancePyramidPtr UTextureSSIMDeduplication::FindOrBuildPyramid(const FAssetData& Asset) const
+{
+    const FSoftObjectPath AssetPath = Asset.GetSoftObjectPath();
+    {
+        FScopeLock Lock(&PyramidsLock);
+        if (const FLuminancePyramidPtr* Found = Pyramids.Find(AssetPath))
+        {
+            return *Found;
+        }
+    }
 
-            Mip.BulkData.Unlock();
+    FLoadedTexture Loaded;
+    Loaded.AssetData = Asset;
+    if (!const_cast<UTextureSSIMDeduplication*>(this)->LoadTextureGrayFromAsset(Asset, Loaded) || !Loaded.bValid || Loaded.Gray.Num() == 0)
+    {
+        return nullptr;
+    }
 
-            OutTexture.bValid = true;
-            WaitEvent->Trigger();
-        });
+    TSharedRef<FLuminancePyramid, ESPMode::ThreadSafe> Pyramid = MakeShared<FLuminancePyramid, ESPMode::ThreadSafe>();
+    BuildPyramid(Loaded, *Pyramid);
 
-    WaitEvent->Wait();
-    FPlatformProcess::ReturnSynchEventToPool(WaitEvent);
-    return OutTexture.bValid;
+    FScopeLock Lock(&PyramidsLock);
+    return Pyramids.Add(AssetPath, Pyramid);
 }
 
-
-
 void UTextureSSIMDeduplication::BuildGaussianKernel(int32 Radius, TArray<float>& OutKernel) const
 {
     int32 Size = Radius * 2 + 1;
@@ -170,34 +798,7 @@ void UTextureSSIMDeduplication::SeparableGaussianBlur(const TArray<float>& In, T
     TArray<float> Temp;
     Temp.SetNumUninitialized(Width * Height);
 
-    for (int32 Y = 0; Y < Height; ++Y)
-    {
-        int32 RowOffset = Y * Width;
-        for (int32 X = 0; X < Width; ++X)
-        {
-            float Sum = 0.0f;
-            for (int32 K = -Radius; K <= Radius; ++K)
-            {
-                int32 SX = FMath::Clamp(X + K, 0, Width - 1);
-                Sum += Kernel[K + Radius] * In[RowOffset + SX];
-            }
-            Temp[RowOffset + X] = Sum;
-        }
-    }
-
-    for (int32 X = 0; X < Width; ++X)
-    {
-        for (int32 Y = 0; Y < Height; ++Y)
-        {
-            float Sum = 0.0f;
-            for (int32 K = -Radius; K <= Radius; ++K)
-            {
-                int32 SY = FMath::Clamp(Y + K, 0, Height - 1);
-                Sum += Kernel[K + Radius] * Temp[SY * Width + X];
-            }
-            Out[Y * Width + X] = Sum;
-        }
-    }
+    TextureSSIMDeduplication::GaussianBlur(In.GetData(), Out.GetData(), Temp.GetData(), Width, Height, Kernel.GetData(), Radius);
 }
 
 void UTextureSSIMDeduplication::Downsample2x(const TArray<float>& In, TArray<float>& Out, int32 InWidth, int32 InHeight, int32& OutWidth, int32& OutHeight) const
@@ -229,48 +830,76 @@ void UTextureSSIMDeduplication::Downsample2x(const TArray<float>& In, TArray<flo
     }
 }
 
-float UTextureSSIMDeduplication::ComputeSSIM(const TArray<float>& A, const TArray<float>& B, int32 Width, int32 Height) const
+TSharedPtr<TextureSSIMDeduplication::FSSIMScratch, ESPMode::ThreadSafe> UTextureSSIMDeduplication::AcquireScratch() const
 {
-    if (A.Num() != B.Num() || A.Num() == 0)
     {
-        return 0.0f;
+        FScopeLock Lock(&ScratchLock);
+        if (IdleScratches.Num() > 0)
+        {
+            return IdleScratches.Pop(EAllowShrinking::No);
+        }
     }
+    return MakeShared<TextureSSIMDeduplication::FSSIMScratch, ESPMode::ThreadSafe>();
+}
 
-    TArray<float> Kernel;
-    BuildGaussianKernel(GaussianRadius, Kernel);
+void UTextureSSIMDeduplication::ReleaseScratch(TSharedPtr<TextureSSIMDeduplication::FSSIMScratch, ESPMode::ThreadSafe> Scratch) const
+{
+    FScopeLock Lock(&ScratchLock);
+    IdleScratches.Add(MoveTemp(Scratch));
+}
 
-    TArray<float> MuA, MuB;
-    SeparableGaussianBlur(A, MuA, Width, Height, Kernel);
-    SeparableGaussianBlur(B, MuB, Width, Height, Kernel);
+float UTextureSSIMDeduplication::ComputeSSIM(const TArray<uint16>& QuantizedA, const TArray<uint16>& QuantizedB, int32 Width, int32 Height, TextureSSIMDeduplication::FSSIMScratch& Scratch) const
+{
+    using namespace TextureSSIMDeduplication;
 
-    TArray<float> A2, B2, AB;
-    int32 PixelCount = Width * Height;
-    A2.SetNumUninitialized(PixelCount);
-    B2.SetNumUninitialized(PixelCount);
-    AB.SetNumUninitialized(PixelCount);
+    if (QuantizedA.Num() != QuantizedB.Num() || QuantizedA.Num() == 0)
+    {
+        return 0.0f;
+    }
 
-    for (int32 i = 0; i < PixelCount; ++i)
+    const int32 PixelCount = Width * Height;
+    Scratch.Reserve(PixelCount);
+    WidenLuminance(QuantizedA.GetData(), PixelCount, Scratch.WideA.GetData());
+    WidenLuminance(QuantizedB.GetData(), PixelCount, Scratch.WideB.GetData());
+    const float* A = Scratch.WideA.GetData();
+    const float* B = Scratch.WideB.GetData();
+
+    if (bUseBoxWindow)
     {
-        A2[i] = A[i] * A[i];
-        B2[i] = B[i] * B[i];
-        AB[i] = A[i] * B[i];
+        BoxMeans(A, B, Width, Height, FMath::Max(GaussianRadius, 0), Scratch);
     }
+    else
+    {
+        if (Scratch.KernelRadius != GaussianRadius)
+        {
+            BuildGaussianKernel(GaussianRadius, Scratch.Kernel);
+            Scratch.KernelRadius = GaussianRadius;
+        }
+        const float* Kernel = Scratch.Kernel.GetData();
+        const int32 Radius = (Scratch.Kernel.Num() - 1) / 2;
+        float* Temp = Scratch.Temp.GetData();
+        float* Product = Scratch.Product.GetData();
 
-    TArray<float> MuA2, MuB2, MuAB;
-    SeparableGaussianBlur(A2, MuA2, Width, Height, Kernel);
-    SeparableGaussianBlur(B2, MuB2, Width, Height, Kernel);
-    SeparableGaussianBlur(AB, MuAB, Width, Height, Kernel);
+        GaussianBlur(A, Scratch.MuA.GetData(), Temp, Width, Height, Kernel, Radius);
+        GaussianBlur(B, Scratch.MuB.GetData(), Temp, Width, Height, Kernel, Radius);
 
-    TArray<float> SigmaA2, SigmaB2, SigmaAB;
-    SigmaA2.SetNumUninitialized(PixelCount);
-    SigmaB2.SetNumUninitialized(PixelCount);
-    SigmaAB.SetNumUninitialized(PixelCount);
+        for (int32 i = 0; i < PixelCount; ++i)
+        {
+            Product[i] = A[i] * A[i];
+        }
+        GaussianBlur(Product, Scratch.MuAA.GetData(), Temp, Width, Height, Kernel, Radius);
 
-    for (int32 i = 0; i < PixelCount; ++i)
-    {
-        SigmaA2[i] = MuA2[i] - MuA[i] * MuA[i];
-        SigmaB2[i] = MuB2[i] - MuB[i] * MuB[i];
-        SigmaAB[i] = MuAB[i] - MuA[i] * MuB[i];
+        for (int32 i = 0; i < PixelCount; ++i)
+        {
+            Product[i] = B[i] * B[i];
+        }
+        GaussianBlur(Product, Scratch.MuBB.GetData(), Temp, Width, Height, Kernel, Radius);
+
+        for (int32 i = 0; i < PixelCount; ++i)
+        {
+            Product[i] = A[i] * B[i];
+        }
+        GaussianBlur(Product, Scratch.MuAB.GetData(), Temp, Width, Height, Kernel, Radius);
     }
 
     const float K1 = 0.01f;
@@ -279,31 +908,16 @@ float UTextureSSIMDeduplication::ComputeSSIM(const TArray<float>& A, const TArra
     const float C1 = (K1 * L) * (K1 * L);
     const float C2 = (K2 * L) * (K2 * L);
 
-    double SumSSIM = 0.0;
-    for (int32 i = 0; i < PixelCount; ++i)
-    {
-        float MuX = MuA[i];
-        float MuY = MuB[i];
-        float SigmaX = SigmaA2[i];
-        float SigmaY = SigmaB2[i];
-        float SigmaXY = SigmaAB[i];
-
-        float NumL = 2.0f * MuX * MuY + C1;
-        float NumC = 2.0f * SigmaXY + C2;
-        float DenL = (MuX * MuX + MuY * MuY + C1);
-        float DenC = (SigmaX + SigmaY + C2);
-
-        float Val = (NumL * NumC) / (DenL * DenC);
-        SumSSIM += FMath::Clamp<double>(Val, 0.0, 1.0);
-    }
+    const double SumSSIM = FDeduplicationSimdKernels::SumSSIM(
+        Scratch.MuA.GetData(), Scratch.MuB.GetData(), Scratch.MuAA.GetData(), Scratch.MuBB.GetData(), Scratch.MuAB.GetData(), PixelCount, C1, C2);
 
     double MeanSSIM = SumSSIM / double(PixelCount);
     return float(MeanSSIM);
 }
 
-float UTextureSSIMDeduplication::ComputeMSSSIM(const TArray<float>& A, const TArray<float>& B, int32 Width, int32 Height) const
+float UTextureSSIMDeduplication::ComputeMSSSIM(const FLuminancePyramid& A, const FLuminancePyramid& B) const
 {
-    if (A.Num() != B.Num() || A.Num() == 0)
+    if (A.Levels.Num() == 0 || A.LevelSizes != B.LevelSizes)
     {
         return 0.0f;
     }
@@ -324,34 +938,17 @@ float UTextureSSIMDeduplication::ComputeMSSSIM(const TArray<float>& A, const TAr
         for (int32 i = 0; i < MSSSIMLevels; ++i) Weights[i] = Equal;
     }
 
-    TArray<float> ImageA = A;
-    TArray<float> ImageB = B;
-    int32 CurW = Width;
-    int32 CurH = Height;
-
     double Product = 1.0;
 
-    for (int32 Level = 0; Level < MSSSIMLevels; ++Level)
+    TSharedPtr<TextureSSIMDeduplication::FSSIMScratch, ESPMode::ThreadSafe> Scratch = AcquireScratch();
+    const int32 NumLevels = FMath::Min(A.Levels.Num(), MSSSIMLevels);
+    for (int32 Level = 0; Level < NumLevels; ++Level)
     {
-        float SsimVal = ComputeSSIM(ImageA, ImageB, CurW, CurH);
+        const FIntPoint Size = A.LevelSizes[Level];
+        float SsimVal = ComputeSSIM(A.Levels[Level], B.Levels[Level], Size.X, Size.Y, *Scratch);
         Product *= FMath::Pow(FMath::Clamp(SsimVal, 0.0f, 1.0f), Weights[Level]);
-
-        if (Level != MSSSIMLevels - 1)
-        {
-            TArray<float> DownA, DownB;
-            int32 OutW = 0, OutH = 0;
-            Downsample2x(ImageA, DownA, CurW, CurH, OutW, OutH);
-            Downsample2x(ImageB, DownB, CurW, CurH, OutW, OutH);
-            ImageA = MoveTemp(DownA);
-            ImageB = MoveTemp(DownB);
-            CurW = OutW;
-            CurH = OutH;
-            if (CurW <= 1 || CurH <= 1)
-            {
-                break;
-            }
-        }
     }
+    ReleaseScratch(MoveTemp(Scratch));
 
     return float(Product);
 }
@@ -366,29 +963,89 @@ TArray<FDuplicateGroup> UTextureSSIMDeduplication::Internal_FindDuplicates_Imple
         return DuplicateGroups;
     }
 
-    TArray<FLoadedTexture> LoadedTextures;
+    {
+        FScopeLock Lock(&PyramidsLock);
+        Pyramids.Reset();
+    }
+
+    TArray<FAssetData> LoadedAssets;
+    TArray<FLuminancePyramidPtr> LoadedTextures;
+    LoadedAssets.Reserve(TotalAssetsNumber);
     LoadedTextures.Reserve(TotalAssetsNumber);
 
+    // Textures are decoded from their sources on all workers, the results are compacted in input order afterwards.
+    TArray<FLuminancePyramidPtr> DecodedTextures;
+    DecodedTextures.SetNum(TotalAssetsNumber);
+    ParallelForItems(TotalAssetsNumber, [this, &AssetsToAnalyze, &DecodedTextures](int32 Index)
+        {
+            DecodedTextures[Index] = FindOrBuildPyramid(AssetsToAnalyze[Index]);
+        });
+
     for (int32 Index = 0; Index < TotalAssetsNumber; ++Index)
     {
-        if (ShouldStop())
+        if (DecodedTextures[Index].IsValid())
         {
-            break;
+            LoadedAssets.Add(AssetsToAnalyze[Index]);
+            LoadedTextures.Add(MoveTemp(DecodedTextures[Index]));
         }
-        
-        SetProgress(float(Index) / float(TotalAssetsNumber));
-        OnDeduplicationProgressCompleted.Broadcast();
+    }
+
+    if (ShouldStop())
+    {
+        FScopeLock Lock(&PyramidsLock);
+        Pyramids.Empty();
+        return DuplicateGroups;
+    }
 
-        FLoadedTexture Loaded;
-        Loaded.AssetData = AssetsToAnalyze[Index];
-        bool bLoaded = LoadTextureGrayFromAsset(AssetsToAnalyze[Index], Loaded);
-        if (bLoaded && Loaded.bValid && Loaded.Gray.Num() > 0)
+    const int32 NumLoaded = LoadedTextures.Num();
+
+    auto PairSimilarity = [this, &LoadedTextures](int32 IndexA, int32 IndexB)
         {
-            LoadedTextures.Add(MoveTemp(Loaded));
+            const FLuminancePyramid& A = *LoadedTextures[IndexA];
+            const FLuminancePyramid& B = *LoadedTextures[IndexB];
+
+            if (!CanCompare(A, B))
+            {
+                return -1.0f;
+            }
+
+            return ComputeMSSSIM(A, B);
+        };
+
+    TArray<FDeduplicationSimilarPair> SimilarPairs;
+    // At radius 64 every pair is within range and the hash has fewer bits than the index needs chunks, so all pairs are compared.
+    if (bUsePerceptualHashPrefilter && PerceptualHashRadius < 64)
+    {
+        TArray<uint64> Hashes;
+        TArray<bool> Flat;
+        Hashes.Reserve(NumLoaded);
+        Flat.Reserve(NumLoaded);
+        for (const FLuminancePyramidPtr& Pyramid : LoadedTextures)
+        {
+            Hashes.Add(Pyramid->PerceptualHash);
+            Flat.Add(Pyramid->bFlat);
         }
+
+        TArray<TPair<int32, int32>> CandidatePairs;
+        TextureSSIMDeduplication::GeneratePerceptualHashCandidates(Hashes, Flat, PerceptualHashRadius, [this]() { return ShouldStop(); }, CandidatePairs);
+        UE_LOG(LogTemp, Log, TEXT("%s perceptual hash prefilter: %d of %lld pairs left for MS-SSIM"),
+            *GetAlgorithmName_Implementation(), CandidatePairs.Num(), static_cast<int64>(NumLoaded) * (NumLoaded - 1) / 2);
+
+        SimilarPairs = FilterSimilarPairs(CandidatePairs, PairSimilarity);
+    }
+    else
+    {
+        SimilarPairs = FindSimilarPairs(NumLoaded, PairSimilarity);
+    }
+
+    // Pairs are sorted by the first index, so the neighbours of every texture form one contiguous range.
+    TArray<int32> FirstPairByTexture;
+    FirstPairByTexture.Init(INDEX_NONE, NumLoaded);
+    for (int32 PairIndex = SimilarPairs.Num() - 1; PairIndex >= 0; --PairIndex)
+    {
+        FirstPairByTexture[SimilarPairs[PairIndex].IndexA] = PairIndex;
     }
 
-    const int32 NumLoaded = LoadedTextures.Num();
     TArray<bool> Assigned;
     Assigned.Init(false, NumLoaded);
 
@@ -405,36 +1062,19 @@ TArray<FDuplicateGroup> UTextureSSIMDeduplication::Internal_FindDuplicates_Imple
         }
 
         TArray<FAssetData> GroupAssets;
-        GroupAssets.Add(LoadedTextures[i].AssetData);
+        GroupAssets.Add(LoadedAssets[i]);
         Assigned[i] = true;
 
-        for (int32 j = i + 1; j < NumLoaded; ++j)
+        for (int32 PairIndex = FirstPairByTexture[i]; PairIndex != INDEX_NONE && PairIndex < SimilarPairs.Num() && SimilarPairs[PairIndex].IndexA == i; ++PairIndex)
         {
-            if (ShouldStop())
-            {
-                break;
-            }
-            
+            const int32 j = SimilarPairs[PairIndex].IndexB;
             if (Assigned[j])
             {
                 continue;
             }
 
-            const FLoadedTexture& A = LoadedTextures[i];
-            const FLoadedTexture& B = LoadedTextures[j];
-
-            if (A.Width != B.Width || A.Height != B.Height)
-            {
-                continue;
-            }
-
-            float Similarity = ComputeMSSSIM(A.Gray, B.Gray, A.Width, A.Height);
-
-            if (Similarity >= SimilarityThreshold)
-            {
-                GroupAssets.Add(B.AssetData);
-                Assigned[j] = true;
-            }
+            GroupAssets.Add(LoadedAssets[j]);
+            Assigned[j] = true;
         }
 
         if (GroupAssets.Num() > 1)
@@ -445,6 +1085,15 @@ TArray<FDuplicateGroup> UTextureSSIMDeduplication::Internal_FindDuplicates_Imple
         }
     }
 
+    {
+        FScopeLock Lock(&PyramidsLock);
+        Pyramids.Empty();
+    }
+    {
+        FScopeLock Lock(&ScratchLock);
+        IdleScratches.Empty();
+    }
+
     SetProgress(1.0f);
     OnDeduplicationProgressCompleted.Broadcast();
 
@@ -459,16 +1108,15 @@ float UTextureSSIMDeduplication::CalculateConfidenceScore_Implementation(const T
         return 1.0f;
     }
 
-    TArray<FLoadedTexture> Loaded;
+    // Pyramids of the current run are reused, so scoring a group does not decode its textures again.
+    TArray<FLuminancePyramidPtr> Loaded;
     Loaded.Reserve(NumAssets);
 
     for (const FAssetData& Asset : CheckAssets)
     {
-        FLoadedTexture LT;
-        const_cast<UTextureSSIMDeduplication*>(this)->LoadTextureGrayFromAsset(Asset, LT);
-        if (LT.bValid)
+        if (FLuminancePyramidPtr Pyramid = FindOrBuildPyramid(Asset))
         {
-            Loaded.Add(MoveTemp(LT));
+            Loaded.Add(MoveTemp(Pyramid));
         }
     }
 
@@ -485,12 +1133,12 @@ float UTextureSSIMDeduplication::CalculateConfidenceScore_Implementation(const T
     {
         for (int32 B = A + 1; B < N; ++B)
         {
-            if (Loaded[A].Width != Loaded[B].Width || Loaded[A].Height != Loaded[B].Height)
+            if (!CanCompare(*Loaded[A], *Loaded[B]))
             {
                 continue;
             }
 
-            float Sim = ComputeMSSSIM(Loaded[A].Gray, Loaded[B].Gray, Loaded[A].Width, Loaded[A].Height);
+            float Sim = ComputeMSSSIM(*Loaded[A], *Loaded[B]);
             TotalSimilarity += double(Sim);
             ++PairCount;
         }
@@ -0,0 +1,331 @@
+/*
+ * Publisher: AO
+ * Year of Publication: 2026
+ * Copyright AO All Rights Reserved.
+ */
+
+#include "DeduplicationAssetByteStore.h"
+#include "Async/ManualResetEvent.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+FDeduplicationAssetBuffer::FDeduplicationAssetBuffer(TArray<uint8>&& InData)
+	: OwnedData(MoveTemp(InData))
+{
+	Data = OwnedData.GetData();
+	Size = OwnedData.Num();
+}
+
+FDeduplicationAssetBuffer::FDeduplicationAssetBuffer(TUniquePtr<IMappedFileHandle>&& InMappedFile, TUniquePtr<IMappedFileRegion>&& InMappedRegion)
+	: MappedFile(MoveTemp(InMappedFile))
+	, MappedRegion(MoveTemp(InMappedRegion))
+{
+	Data = MappedRegion->GetMappedPtr();
+	Size = static_cast<int32>(MappedRegion->GetMappedSize());
+}
+
+FDeduplicationAssetBuffer::FDeduplicationAssetBuffer(TSharedPtr<const FDeduplicationAssetBuffer, ESPMode::ThreadSafe> InParent, int32 Offset, int32 InSize)
+	: Parent(MoveTemp(InParent))
+{
+	check(Parent.IsValid() && Offset >= 0 && InSize >= 0 && Offset + InSize <= Parent->Num());
+	Data = Parent->GetData() + Offset;
+	Size = InSize;
+}
+
+FDeduplicationAssetBuffer::~FDeduplicationAssetBuffer()
+{
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+FDeduplicationAssetBytes FDeduplicationAssetBuffer::MapFile(const FString& Filename)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	FOpenMappedResult OpenResult = PlatformFile.OpenMappedEx(*Filename);
+	if (OpenResult.HasError())
+	{
+		return nullptr;
+	}
+
+	TUniquePtr<IMappedFileHandle> MappedFile = OpenResult.StealValue();
+	const int64 FileSize = MappedFile.IsValid() ? MappedFile->GetFileSize() : 0;
+	if (FileSize <= 0 || FileSize > MAX_int32)
+	{
+		return nullptr;
+	}
+
+	TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile->MapRegion(0, FileSize));
+	if (!MappedRegion.IsValid())
+	{
+		return nullptr;
+	}
+
+	return MakeShared<FDeduplicationAssetBuffer, ESPMode::ThreadSafe>(MoveTemp(MappedFile), MoveTemp(MappedRegion));
+}
+
+FDeduplicationAssetBytes FDeduplicationAssetBuffer::ReadFile(const FString& Filename, bool bAllowMapping)
+{
+	if (bAllowMapping)
+	{
+		if (FDeduplicationAssetBytes Mapped = MapFile(Filename))
+		{
+			return Mapped;
+		}
+	}
+
+	TArray<uint8> LoadedData;
+	if (!FFileHelper::LoadFileToArray(LoadedData, *Filename, FILEREAD_Silent))
+	{
+		return nullptr;
+	}
+	return MakeShared<FDeduplicationAssetBuffer, ESPMode::ThreadSafe>(MoveTemp(LoadedData));
+}
+
+FDeduplicationAssetByteStore::FDeduplicationAssetByteStore(int64 InMemoryBudgetBytes, bool bInSpillToDisk, int32 InMaxLiveMappings)
+	: MemoryBudgetBytes(FMath::Max<int64>(0, InMemoryBudgetBytes))
+	, MaxLiveMappings(FMath::Max(1, InMaxLiveMappings))
+	, bSpillToDisk(bInSpillToDisk)
+	, StoreId(FGuid::NewGuid())
+{
+}
+
+FDeduplicationAssetByteStore::~FDeduplicationAssetByteStore()
+{
+	Reset();
+}
+
+FString FDeduplicationAssetByteStore::GetSpillDirectory() const
+{
+	return FPaths::ProjectSavedDir() / TEXT("DeduplicationCache") / TEXT("Spill") / StoreId.ToString();
+}
+
+int64 FDeduplicationAssetByteStore::GetResidentBytes() const
+{
+	FScopeLock Lock(&StoreLock);
+	return ResidentBytes;
+}
+
+void FDeduplicationAssetByteStore::Touch(FEntry& Entry, const FSoftObjectPath& AssetPath)
+{
+	// Mapped buffers are limited by count and heap buffers by size, so each kind has its own LRU list.
+	TDoubleLinkedList<FSoftObjectPath>& List = Entry.Data.IsValid() && Entry.Data->IsMapped() ? MappedLruList : LruList;
+	if (Entry.LruNode != nullptr)
+	{
+		List.RemoveNode(Entry.LruNode, /*bDeleteNode=*/ false);
+		List.AddHead(Entry.LruNode);
+	}
+	else
+	{
+		List.AddHead(AssetPath);
+		Entry.LruNode = List.GetHead();
+	}
+}
+
+FDeduplicationAssetBytes FDeduplicationAssetByteStore::FindResident(const FSoftObjectPath& AssetPath, bool& bOutKnownFailure, FString& OutSpillFilePath, TSharedPtr<UE::FManualResetEvent, ESPMode::ThreadSafe>& OutPendingLoad)
+{
+	bOutKnownFailure = false;
+	OutSpillFilePath.Reset();
+	OutPendingLoad.Reset();
+
+	FEntry* Entry = Entries.Find(AssetPath);
+	if (Entry == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (Entry->bLoadFailed)
+	{
+		bOutKnownFailure = true;
+		return nullptr;
+	}
+
+	if (Entry->Data.IsValid())
+	{
+		Touch(*Entry, AssetPath);
+		return Entry->Data;
+	}
+
+	OutPendingLoad = Entry->PendingLoad;
+	OutSpillFilePath = Entry->SpillFilePath;
+	return nullptr;
+}
+
+FDeduplicationAssetBytes FDeduplicationAssetByteStore::GetAssetBytes(const FAssetData& Asset, TFunctionRef<FDeduplicationAssetBytes()> Loader)
+{
+	const FSoftObjectPath AssetPath = Asset.GetSoftObjectPath();
+
+	FString SpillFilePath;
+	TSharedPtr<UE::FManualResetEvent, ESPMode::ThreadSafe> LoadFinished;
+	while (true)
+	{
+		TSharedPtr<UE::FManualResetEvent, ESPMode::ThreadSafe> PendingLoad;
+		{
+			FScopeLock Lock(&StoreLock);
+			bool bKnownFailure = false;
+			FDeduplicationAssetBytes Resident = FindResident(AssetPath, bKnownFailure, SpillFilePath, PendingLoad);
+			if (Resident.IsValid() || bKnownFailure)
+			{
+				return Resident;
+			}
+
+			if (!PendingLoad.IsValid())
+			{
+				// This worker loads the asset, others asking for it meanwhile wait for the result instead of loading it again.
+				LoadFinished = MakeShared<UE::FManualResetEvent, ESPMode::ThreadSafe>();
+				Entries.FindOrAdd(AssetPath).PendingLoad = LoadFinished;
+				break;
+			}
+		}
+
+		PendingLoad->Wait();
+	}
+
+	// Load outside of the lock, other workers may keep reading resident buffers meanwhile.
+	bool bMayLoad = false;
+	{
+		FScopeLock Lock(&StoreLock);
+		bMayLoad = !bSealed;
+	}
+
+	FDeduplicationAssetBytes LoadedBytes;
+	if (!SpillFilePath.IsEmpty())
+	{
+		LoadedBytes = FDeduplicationAssetBuffer::ReadFile(SpillFilePath, /*bAllowMapping=*/ true);
+		if (!LoadedBytes.IsValid())
+		{
+			// Spilled bytes are the ones that are expensive or unsafe to load again, possibly on a thread that must not load them.
+			UE_LOG(LogTemp, Warning, TEXT("Failed to read spilled asset bytes of %s from %s"), *AssetPath.ToString(), *SpillFilePath);
+			SpillFilePath.Reset();
+		}
+	}
+	else if (bMayLoad)
+	{
+		LoadedBytes = Loader();
+	}
+
+	FScopeLock Lock(&StoreLock);
+	FEntry& Entry = Entries.FindOrAdd(AssetPath);
+	Entry.PendingLoad.Reset();
+	LoadFinished->Notify();
+
+	if (!LoadedBytes.IsValid())
+	{
+		Entry.bLoadFailed = true;
+		return nullptr;
+	}
+
+	Entry.Data = LoadedBytes;
+	Entry.SpillFilePath = SpillFilePath;
+	if (LoadedBytes->IsMapped())
+	{
+		// Mapped pages belong to the OS page cache and cost no heap memory, only the number of open mappings is limited.
+		Entry.Size = 0;
+		Touch(Entry, AssetPath);
+		EvictMappings(AssetPath);
+		return LoadedBytes;
+	}
+
+	Entry.Size = LoadedBytes->Num();
+	ResidentBytes += Entry.Size;
+	Touch(Entry, AssetPath);
+	EvictToBudget(AssetPath);
+	return LoadedBytes;
+}
+
+void FDeduplicationAssetByteStore::Seal()
+{
+	FScopeLock Lock(&StoreLock);
+	bSealed = true;
+}
+
+void FDeduplicationAssetByteStore::EvictToBudget(const FSoftObjectPath& KeepAssetPath)
+{
+	while (ResidentBytes > MemoryBudgetBytes)
+	{
+		TDoubleLinkedList<FSoftObjectPath>::TDoubleLinkedListNode* Tail = LruList.GetTail();
+		if (Tail == nullptr || Tail->GetValue() == KeepAssetPath)
+		{
+			break;
+		}
+
+		const FSoftObjectPath EvictedPath = Tail->GetValue();
+		LruList.RemoveNode(Tail);
+
+		FEntry* Entry = Entries.Find(EvictedPath);
+		if (Entry == nullptr)
+		{
+			continue;
+		}
+		Entry->LruNode = nullptr;
+
+		if (bSpillToDisk && Entry->SpillFilePath.IsEmpty() && Entry->Data.IsValid())
+		{
+			const FString SpillDirectory = GetSpillDirectory();
+			IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+			if (!PlatformFile.DirectoryExists(*SpillDirectory))
+			{
+				PlatformFile.CreateDirectoryTree(*SpillDirectory);
+			}
+
+			const FString SpillFilePath = SpillDirectory / FString::Printf(TEXT("%d.bin"), NextSpillFileIndex++);
+			if (FFileHelper::SaveArrayToFile(Entry->Data->GetView(), *SpillFilePath))
+			{
+				Entry->SpillFilePath = SpillFilePath;
+			}
+			else
+			{
+				// Spilled bytes are the ones that are expensive or unsafe to load again, so keep them above the budget instead.
+				// The buffer is out of the LRU list until its next access, which retries the spill on a later eviction.
+				UE_LOG(LogTemp, Warning, TEXT("Failed to spill asset bytes of %s to %s, keeping them in memory"), *EvictedPath.ToString(), *SpillFilePath);
+				continue;
+			}
+		}
+
+		ResidentBytes -= Entry->Size;
+		Entry->Data.Reset();
+	}
+}
+
+void FDeduplicationAssetByteStore::EvictMappings(const FSoftObjectPath& KeepAssetPath)
+{
+	while (MappedLruList.Num() > MaxLiveMappings)
+	{
+		TDoubleLinkedList<FSoftObjectPath>::TDoubleLinkedListNode* Tail = MappedLruList.GetTail();
+		if (Tail == nullptr || Tail->GetValue() == KeepAssetPath)
+		{
+			break;
+		}
+
+		const FSoftObjectPath EvictedPath = Tail->GetValue();
+		MappedLruList.RemoveNode(Tail);
+
+		// The file is closed once callers holding the buffer release it. The spill file path is kept, so spilled bytes are mapped
+		// back from there, package files are simply mapped again by the loader.
+		if (FEntry* Entry = Entries.Find(EvictedPath))
+		{
+			Entry->LruNode = nullptr;
+			Entry->Data.Reset();
+		}
+	}
+}
+
+void FDeduplicationAssetByteStore::Reset()
+{
+	FScopeLock Lock(&StoreLock);
+	LruList.Empty();
+	MappedLruList.Empty();
+	Entries.Empty();
+	ResidentBytes = 0;
+	NextSpillFileIndex = 0;
+	bSealed = false;
+
+	const FString SpillDirectory = GetSpillDirectory();
+	if (IFileManager::Get().DirectoryExists(*SpillDirectory))
+	{
+		IFileManager::Get().DeleteDirectory(*SpillDirectory, /*RequireExists=*/ false, /*Tree=*/ true);
+	}
+}
@@ -0,0 +1,86 @@
+/*
+ * Publisher: AO
+ * Year of Publication: 2026
+ * Copyright AO All Rights Reserved.
+ */
+
+#include "DeduplicationAssetTable.h"
+#include "DeduplicateObjects/DeduplicateObject.h"
+
+void FDeduplicationAssetTable::Reset()
+{
+	Assets.Empty();
+	IdsByPath.Empty();
+}
+
+int32 FDeduplicationAssetTable::Intern(const FAssetData& Asset)
+{
+	const FSoftObjectPath AssetPath = Asset.GetSoftObjectPath();
+	if (const int32* FoundId = IdsByPath.Find(AssetPath))
+	{
+		return *FoundId;
+	}
+
+	const int32 NewId = Assets.Add(Asset);
+	IdsByPath.Add(AssetPath, NewId);
+	return NewId;
+}
+
+int32 FDeduplicationAssetTable::Find(const FAssetData& Asset) const
+{
+	const int32* FoundId = IdsByPath.Find(Asset.GetSoftObjectPath());
+	return FoundId != nullptr ? *FoundId : INDEX_NONE;
+}
+
+void FDeduplicationAssetTable::CompactGroup(FDuplicateGroup& Group) const
+{
+	if (Group.DuplicateAssets.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<int32> AssetIds;
+	AssetIds.Reserve(Group.DuplicateAssets.Num());
+	for (const FAssetData& Asset : Group.DuplicateAssets)
+	{
+		const int32 AssetId = Find(Asset);
+		if (AssetId == INDEX_NONE)
+		{
+			return;
+		}
+		AssetIds.Add(AssetId);
+	}
+
+	Group.AssetIds = MoveTemp(AssetIds);
+	Group.DuplicateAssets.Empty();
+}
+
+void FDeduplicationAssetTable::GetGroupAssets(const FDuplicateGroup& Group, TArray<FAssetData>& OutAssets) const
+{
+	if (Group.DuplicateAssets.Num() > 0)
+	{
+		OutAssets = Group.DuplicateAssets;
+		return;
+	}
+
+	OutAssets.Reset(Group.AssetIds.Num());
+	for (int32 AssetId : Group.AssetIds)
+	{
+		OutAssets.Add(Assets[AssetId]);
+	}
+}
+
+void FDeduplicationAssetTable::GetGroupAssetIds(const FDuplicateGroup& Group, TArray<int32>& OutAssetIds)
+{
+	if (Group.DuplicateAssets.Num() == 0)
+	{
+		OutAssetIds = Group.AssetIds;
+		return;
+	}
+
+	OutAssetIds.Reset(Group.DuplicateAssets.Num());
+	for (const FAssetData& Asset : Group.DuplicateAssets)
+	{
+		OutAssetIds.Add(Intern(Asset));
+	}
+}
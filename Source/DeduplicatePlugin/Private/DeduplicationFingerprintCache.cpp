@@ -0,0 +1,562 @@
+/*
+ * Publisher: AO
+ * Year of Publication: 2026
+ * Copyright AO All Rights Reserved.
+ */
+
+#include "DeduplicationFingerprintCache.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/Blueprint.h"
+#include "Hash/Blake3.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/Class.h"
+#include "UObject/PropertyPortFlags.h"
+#include "UObject/UnrealType.h"
+
+namespace DeduplicationFingerprintCache
+{
+	static const uint32 FileMagic = 0x44445046; // "DDPF"
+	static const uint32 IndexMagic = 0x44445049; // "DDPI"
+	// v2: one file per shard plus an index, v1 kept every package in a single Fingerprints.bin.
+	static const int32 FileVersion = 2;
+
+	// Guards against parent tags that form a cycle in a broken Asset Registry.
+	static const int32 MaxClassHierarchyDepth = 64;
+
+	static void HashString(FBlake3& Hasher, const FString& Value)
+	{
+		Hasher.Update(*Value, Value.Len() * sizeof(TCHAR));
+	}
+
+	static bool GetParentClassPath(const FAssetData& Asset, FString& OutClassPath)
+	{
+		FString ExportTextPath;
+		if (!Asset.GetTagValue(FBlueprintTags::ParentClassPath, ExportTextPath) || ExportTextPath.IsEmpty())
+		{
+			return false;
+		}
+		OutClassPath = FPackageName::ExportTextPathToObjectPath(ExportTextPath);
+		return true;
+	}
+
+	// Location of the single file cache written before sharding.
+	static FString GetLegacyCacheFilePath()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("DeduplicationCache") / TEXT("Fingerprints.bin");
+	}
+
+	static bool MatchesScopeHash(TConstArrayView<uint8> Payload, const TOptional<FIoHash>& ScopeHash)
+	{
+		return !ScopeHash.IsSet()
+			|| (Payload.Num() >= static_cast<int32>(sizeof(FIoHash)) && FMemory::Memcmp(Payload.GetData(), &ScopeHash.GetValue(), sizeof(FIoHash)) == 0);
+	}
+}
+
+FDeduplicationFingerprintCache& FDeduplicationFingerprintCache::Get()
+{
+	static FDeduplicationFingerprintCache Instance;
+	return Instance;
+}
+
+FString FDeduplicationFingerprintCache::GetCacheDirectory()
+{
+	return FPaths::ProjectSavedDir() / TEXT("DeduplicationCache") / TEXT("Fingerprints");
+}
+
+FString FDeduplicationFingerprintCache::GetShardFilePath(int32 ShardIndex)
+{
+	return GetCacheDirectory() / FString::Printf(TEXT("Shard%02X.bin"), ShardIndex);
+}
+
+FString FDeduplicationFingerprintCache::GetIndexFilePath()
+{
+	return GetCacheDirectory() / TEXT("Index.bin");
+}
+
+int32 FDeduplicationFingerprintCache::GetShardIndex(FName PackageName)
+{
+	// FName hashes differ between sessions, the shard of a package has to be stable on disk.
+	return static_cast<int32>(FCrc::StrCrc32(*PackageName.ToString().ToLower()) & (NumShards - 1));
+}
+
+bool FDeduplicationFingerprintCache::GetFingerprintKey(const FAssetData& Asset, FDeduplicationFingerprintKey& OutKey)
+{
+	{
+		FScopeLock Lock(&CacheLock);
+		if (const TOptional<FDeduplicationFingerprintKey>* RunKey = RunKeys.Find(Asset.PackageName))
+		{
+			if (RunKey->IsSet())
+			{
+				OutKey = RunKey->GetValue();
+			}
+			return RunKey->IsSet();
+		}
+	}
+
+	// Query outside of the lock, so workers resolving different packages do not wait on each other's file system calls.
+	FDeduplicationFingerprintKey ComputedKey;
+	const bool bHasKey = ComputeFingerprintKey(Asset, ComputedKey);
+
+	FScopeLock Lock(&CacheLock);
+	RunKeys.Add(Asset.PackageName, bHasKey ? TOptional<FDeduplicationFingerprintKey>(ComputedKey) : TOptional<FDeduplicationFingerprintKey>());
+	if (bHasKey)
+	{
+		OutKey = ComputedKey;
+	}
+	return bHasKey;
+}
+
+bool FDeduplicationFingerprintCache::ComputeFingerprintKey(const FAssetData& Asset, FDeduplicationFingerprintKey& OutKey)
+{
+	const FString PackageName = Asset.PackageName.ToString();
+	FString Filename;
+	if (!FPackageName::DoesPackageExist(PackageName, &Filename))
+	{
+		return false;
+	}
+
+	OutKey = FDeduplicationFingerprintKey();
+	OutKey.TimeStamp = IFileManager::Get().GetTimeStamp(*Filename);
+	OutKey.DiskSize = IFileManager::Get().FileSize(*Filename);
+
+	if (IAssetRegistry* AssetRegistry = IAssetRegistry::Get())
+	{
+		TOptional<FAssetPackageData> PackageData = AssetRegistry->GetAssetPackageDataCopy(Asset.PackageName);
+		if (PackageData.IsSet())
+		{
+			OutKey.PackageSavedHash = PackageData->GetPackageSavedHash();
+		}
+	}
+
+	return OutKey.DiskSize >= 0;
+}
+
+TOptional<FIoHash> FDeduplicationFingerprintCache::GetScopeHash(const FAssetData& Asset, EDeduplicationFingerprintScope Scope)
+{
+	if (Scope == EDeduplicationFingerprintScope::Package)
+	{
+		return TOptional<FIoHash>();
+	}
+	return GetClassHierarchyHash(Asset);
+}
+
+FIoHash FDeduplicationFingerprintCache::GetClassHierarchyHash(const FAssetData& Asset)
+{
+	{
+		FScopeLock Lock(&CacheLock);
+		if (const FIoHash* RunHash = RunHierarchyHashes.Find(Asset.PackageName))
+		{
+			return *RunHash;
+		}
+	}
+
+	const FIoHash ComputedHash = ComputeClassHierarchyHash(Asset);
+
+	FScopeLock Lock(&CacheLock);
+	RunHierarchyHashes.Add(Asset.PackageName, ComputedHash);
+	return ComputedHash;
+}
+
+FIoHash FDeduplicationFingerprintCache::ComputeClassHierarchyHash(const FAssetData& Asset)
+{
+	using namespace DeduplicationFingerprintCache;
+
+	FBlake3 Hasher;
+	IAssetRegistry* AssetRegistry = IAssetRegistry::Get();
+
+	// Blueprints name the parent of their generated class in a tag, other assets start from their own class.
+	FString ClassPath;
+	if (!GetParentClassPath(Asset, ClassPath))
+	{
+		ClassPath = Asset.AssetClassPath.ToString();
+	}
+
+	for (int32 Depth = 0; Depth < MaxClassHierarchyDepth && !ClassPath.IsEmpty(); ++Depth)
+	{
+		HashString(Hasher, ClassPath);
+
+		const FString PackageName = FPackageName::ObjectPathToPackageName(ClassPath);
+		if (FPackageName::IsScriptPackage(PackageName))
+		{
+			const FIoHash NativeHash = GetNativeClassHash(ClassPath);
+			Hasher.Update(&NativeHash, sizeof(NativeHash));
+			break;
+		}
+
+		// A blueprint generated class lives in the package of its blueprint, which holds the saved state and the next parent tag.
+		FAssetData ParentBlueprint;
+		if (AssetRegistry != nullptr)
+		{
+			TArray<FAssetData> PackageAssets;
+			AssetRegistry->GetAssetsByPackageName(FName(*PackageName), PackageAssets, /*bIncludeOnlyOnDiskAssets=*/ true);
+			for (const FAssetData& PackageAsset : PackageAssets)
+			{
+				if (PackageAsset.FindTag(FBlueprintTags::ParentClassPath))
+				{
+					ParentBlueprint = PackageAsset;
+					break;
+				}
+			}
+		}
+
+		FDeduplicationFingerprintKey ParentKey;
+		if (!ParentBlueprint.IsValid() || !GetFingerprintKey(ParentBlueprint, ParentKey))
+		{
+			break;
+		}
+
+		const int64 ParentTicks = ParentKey.TimeStamp.GetTicks();
+		Hasher.Update(&ParentKey.PackageSavedHash, sizeof(ParentKey.PackageSavedHash));
+		Hasher.Update(&ParentKey.DiskSize, sizeof(ParentKey.DiskSize));
+		Hasher.Update(&ParentTicks, sizeof(ParentTicks));
+
+		ClassPath.Reset();
+		GetParentClassPath(ParentBlueprint, ClassPath);
+	}
+
+	return FIoHash(Hasher.Finalize());
+}
+
+FIoHash FDeduplicationFingerprintCache::GetNativeClassHash(const FString& ClassPath)
+{
+	using namespace DeduplicationFingerprintCache;
+
+	{
+		FScopeLock Lock(&CacheLock);
+		if (const FIoHash* RunHash = RunNativeClassHashes.Find(ClassPath))
+		{
+			return *RunHash;
+		}
+	}
+
+	// Native classes have no saved package, so their layout and default values stand in for it. Both change only with a recompile.
+	FBlake3 Hasher;
+	if (const UClass* NativeClass = FindObject<UClass>(nullptr, *ClassPath))
+	{
+		const UObject* DefaultObject = NativeClass->GetDefaultObject(/*bCreateIfNeeded=*/ false);
+		for (TFieldIterator<FProperty> PropertyIt(NativeClass); PropertyIt; ++PropertyIt)
+		{
+			const FProperty* Property = *PropertyIt;
+			const int32 Offset = Property->GetOffset_ForInternal();
+			const uint64 Flags = static_cast<uint64>(Property->GetPropertyFlags());
+			HashString(Hasher, Property->GetName());
+			HashString(Hasher, Property->GetCPPType());
+			Hasher.Update(&Offset, sizeof(Offset));
+			Hasher.Update(&Flags, sizeof(Flags));
+
+			if (DefaultObject != nullptr)
+			{
+				FString DefaultValue;
+				Property->ExportTextItem_InContainer(DefaultValue, DefaultObject, nullptr, nullptr, PPF_None);
+				HashString(Hasher, DefaultValue);
+			}
+		}
+	}
+
+	const FIoHash ComputedHash(Hasher.Finalize());
+
+	FScopeLock Lock(&CacheLock);
+	RunNativeClassHashes.Add(ClassPath, ComputedHash);
+	return ComputedHash;
+}
+
+void FDeduplicationFingerprintCache::LoadIndexIfNeeded()
+{
+	using namespace DeduplicationFingerprintCache;
+
+	if (bIndexLoaded)
+	{
+		return;
+	}
+	bIndexLoaded = true;
+	ShardEntryCounts.Init(INDEX_NONE, NumShards);
+
+	// Caches written before sharding are not migrated, their features are rebuilt on the next run.
+	const FString LegacyCacheFilePath = GetLegacyCacheFilePath();
+	if (IFileManager::Get().FileExists(*LegacyCacheFilePath))
+	{
+		UE_LOG(LogTemp, Log, TEXT("Deduplication fingerprint cache has an outdated format and will be rebuilt"));
+		IFileManager::Get().Delete(*LegacyCacheFilePath, false, false, true);
+	}
+
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *GetIndexFilePath(), FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Reader(FileData, /*bIsPersistent=*/ true);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	TArray<int32> LoadedCounts;
+	Reader << Magic;
+	Reader << Version;
+	if (Magic != IndexMagic || Version != FileVersion)
+	{
+		return;
+	}
+	Reader << LoadedCounts;
+	if (!Reader.IsError() && LoadedCounts.Num() == NumShards)
+	{
+		ShardEntryCounts = MoveTemp(LoadedCounts);
+	}
+}
+
+void FDeduplicationFingerprintCache::LoadShard(int32 ShardIndex, FShard& Shard)
+{
+	using namespace DeduplicationFingerprintCache;
+
+	if (ShardEntryCounts[ShardIndex] == 0)
+	{
+		return;
+	}
+
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *GetShardFilePath(ShardIndex), FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Reader(FileData, /*bIsPersistent=*/ true);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	Reader << Magic;
+	Reader << Version;
+	if (Magic != FileMagic || Version != FileVersion)
+	{
+		Shard.bDirty = true;
+		return;
+	}
+
+	TMap<FName, FDeduplicationFingerprintEntry> LoadedEntries;
+	Reader << LoadedEntries;
+	if (Reader.IsError())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Deduplication fingerprint cache shard %d is corrupted and will be rebuilt"), ShardIndex);
+		Shard.bDirty = true;
+		return;
+	}
+	Shard.Entries = MoveTemp(LoadedEntries);
+
+	// While the Asset Registry is still scanning, packages it has not reached yet would look deleted.
+	IAssetRegistry* AssetRegistry = IAssetRegistry::Get();
+	if (AssetRegistry == nullptr || AssetRegistry->IsLoadingAssets())
+	{
+		return;
+	}
+
+	for (TMap<FName, FDeduplicationFingerprintEntry>::TIterator It = Shard.Entries.CreateIterator(); It; ++It)
+	{
+		if (!AssetRegistry->GetAssetPackageDataCopy(It.Key()).IsSet())
+		{
+			It.RemoveCurrent();
+			Shard.bDirty = true;
+		}
+	}
+}
+
+FDeduplicationFingerprintCache::FShard& FDeduplicationFingerprintCache::GetShard(FName PackageName)
+{
+	LoadIndexIfNeeded();
+
+	const int32 ShardIndex = GetShardIndex(PackageName);
+	FShard& Shard = Shards[ShardIndex];
+	if (!Shard.bLoaded)
+	{
+		Shard.bLoaded = true;
+		LoadShard(ShardIndex, Shard);
+	}
+	return Shard;
+}
+
+bool FDeduplicationFingerprintCache::FindFeature(const FAssetData& Asset, FName FeatureName, TArray<uint8>& OutPayload, EDeduplicationFingerprintScope Scope)
+{
+	using namespace DeduplicationFingerprintCache;
+
+	FDeduplicationFingerprintKey CurrentKey;
+	if (!GetFingerprintKey(Asset, CurrentKey))
+	{
+		return false;
+	}
+	const TOptional<FIoHash> ScopeHash = GetScopeHash(Asset, Scope);
+
+	FScopeLock Lock(&CacheLock);
+	FShard& Shard = GetShard(Asset.PackageName);
+
+	FDeduplicationFingerprintEntry* Entry = Shard.Entries.Find(Asset.PackageName);
+	if (Entry == nullptr)
+	{
+		return false;
+	}
+
+	if (Entry->Key != CurrentKey)
+	{
+		Shard.Entries.Remove(Asset.PackageName);
+		Shard.bDirty = true;
+		return false;
+	}
+
+	const TArray<uint8>* Payload = Entry->Features.Find(FeatureName);
+	if (Payload == nullptr || !MatchesScopeHash(*Payload, ScopeHash))
+	{
+		return false;
+	}
+
+	const int32 HeaderSize = ScopeHash.IsSet() ? static_cast<int32>(sizeof(FIoHash)) : 0;
+	OutPayload.Reset(Payload->Num() - HeaderSize);
+	OutPayload.Append(Payload->GetData() + HeaderSize, Payload->Num() - HeaderSize);
+	return true;
+}
+
+bool FDeduplicationFingerprintCache::HasFeature(const FAssetData& Asset, FName FeatureName, EDeduplicationFingerprintScope Scope)
+{
+	using namespace DeduplicationFingerprintCache;
+
+	FDeduplicationFingerprintKey CurrentKey;
+	if (!GetFingerprintKey(Asset, CurrentKey))
+	{
+		return false;
+	}
+	const TOptional<FIoHash> ScopeHash = GetScopeHash(Asset, Scope);
+
+	FScopeLock Lock(&CacheLock);
+	const FDeduplicationFingerprintEntry* Entry = GetShard(Asset.PackageName).Entries.Find(Asset.PackageName);
+	if (Entry == nullptr || Entry->Key != CurrentKey)
+	{
+		return false;
+	}
+
+	const TArray<uint8>* Payload = Entry->Features.Find(FeatureName);
+	return Payload != nullptr && MatchesScopeHash(*Payload, ScopeHash);
+}
+
+void FDeduplicationFingerprintCache::StoreFeature(const FAssetData& Asset, FName FeatureName, TArray<uint8>&& Payload, EDeduplicationFingerprintScope Scope)
+{
+	FDeduplicationFingerprintKey CurrentKey;
+	if (!GetFingerprintKey(Asset, CurrentKey))
+	{
+		return;
+	}
+
+	const TOptional<FIoHash> ScopeHash = GetScopeHash(Asset, Scope);
+	if (ScopeHash.IsSet())
+	{
+		Payload.Insert(reinterpret_cast<const uint8*>(&ScopeHash.GetValue()), sizeof(FIoHash), 0);
+	}
+
+	FScopeLock Lock(&CacheLock);
+	FShard& Shard = GetShard(Asset.PackageName);
+
+	FDeduplicationFingerprintEntry& Entry = Shard.Entries.FindOrAdd(Asset.PackageName);
+	if (Entry.Key != CurrentKey)
+	{
+		Entry.Key = CurrentKey;
+		Entry.Features.Empty();
+	}
+	Entry.Features.Add(FeatureName, MoveTemp(Payload));
+	Shard.bDirty = true;
+}
+
+void FDeduplicationFingerprintCache::Flush()
+{
+	using namespace DeduplicationFingerprintCache;
+
+	// Dirty shards are serialized under the lock, the files are written after releasing it so workers are not held up by the disk.
+	TArray<TPair<int32, TArray<uint8>>> ShardFiles;
+	TArray<uint8> IndexData;
+	{
+		FScopeLock Lock(&CacheLock);
+		for (int32 ShardIndex = 0; ShardIndex < NumShards; ++ShardIndex)
+		{
+			FShard& Shard = Shards[ShardIndex];
+			if (!Shard.bDirty)
+			{
+				continue;
+			}
+
+			TArray<uint8>& FileData = ShardFiles.Emplace_GetRef(ShardIndex, TArray<uint8>()).Value;
+			if (Shard.Entries.Num() > 0)
+			{
+				FMemoryWriter Writer(FileData, /*bIsPersistent=*/ true);
+				uint32 Magic = FileMagic;
+				int32 Version = FileVersion;
+				Writer << Magic;
+				Writer << Version;
+				Writer << Shard.Entries;
+			}
+			ShardEntryCounts[ShardIndex] = Shard.Entries.Num();
+			Shard.bDirty = false;
+		}
+
+		if (ShardFiles.Num() == 0)
+		{
+			return;
+		}
+
+		FMemoryWriter Writer(IndexData, /*bIsPersistent=*/ true);
+		uint32 Magic = IndexMagic;
+		int32 Version = FileVersion;
+		Writer << Magic;
+		Writer << Version;
+		Writer << ShardEntryCounts;
+	}
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString CacheDirectory = GetCacheDirectory();
+	if (!PlatformFile.DirectoryExists(*CacheDirectory))
+	{
+		PlatformFile.CreateDirectoryTree(*CacheDirectory);
+	}
+
+	for (const TPair<int32, TArray<uint8>>& ShardFile : ShardFiles)
+	{
+		const FString ShardFilePath = GetShardFilePath(ShardFile.Key);
+		// Empty shards are removed, the index records them with no entries.
+		const bool bSaved = ShardFile.Value.Num() == 0
+			? IFileManager::Get().Delete(*ShardFilePath, false, false, true)
+			: FFileHelper::SaveArrayToFile(ShardFile.Value, *ShardFilePath);
+		if (!bSaved)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Failed to save deduplication fingerprint cache shard to %s"), *ShardFilePath);
+			FScopeLock Lock(&CacheLock);
+			Shards[ShardFile.Key].bDirty = true;
+		}
+	}
+
+	if (!FFileHelper::SaveArrayToFile(IndexData, *GetIndexFilePath()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Failed to save deduplication fingerprint cache index to %s"), *GetIndexFilePath());
+	}
+}
+
+void FDeduplicationFingerprintCache::Clear()
+{
+	FScopeLock Lock(&CacheLock);
+	for (FShard& Shard : Shards)
+	{
+		Shard.Entries.Empty();
+		Shard.bLoaded = true;
+		Shard.bDirty = false;
+	}
+	ShardEntryCounts.Init(0, NumShards);
+	bIndexLoaded = true;
+	RunKeys.Empty();
+	RunHierarchyHashes.Empty();
+	RunNativeClassHashes.Empty();
+	IFileManager::Get().DeleteDirectory(*GetCacheDirectory(), false, true);
+	IFileManager::Get().Delete(*DeduplicationFingerprintCache::GetLegacyCacheFilePath(), false, false, true);
+}
+
+void FDeduplicationFingerprintCache::ResetFingerprintKeys()
+{
+	FScopeLock Lock(&CacheLock);
+	RunKeys.Empty();
+	RunHierarchyHashes.Empty();
+	RunNativeClassHashes.Empty();
+}
@@ -412,70 +412,299 @@ TArray<FAssetData> UDeduplicationFunctionLibrary::FilterRedirects(const TArray<F
 	return Filtered;
 }
 
-int32 UDeduplicationFunctionLibrary::FindCommonSubstrings(const TArray<uint8>& Data1, const TArray<uint8>& Data2, int32 MinLength)
+namespace DeduplicationFunctionLibrary
 {
+	static const uint64 RollingHashBase = 0x100000001B3ull;
+
+	// Calls Visitor(Offset, Key) for every MinLength-gram. Grams of up to 8 bytes are packed into the key exactly,
+	// longer grams get a polynomial rolling hash, so every window costs O(1).
+	template<typename VisitorType>
+	static void ForEachGram(TArrayView<const uint8> Data, int32 MinLength, VisitorType&& Visitor)
+	{
+		const int32 NumGrams = Data.Num() - MinLength + 1;
+		if (NumGrams <= 0)
+		{
+			return;
+		}
+
+		const uint8* Bytes = Data.GetData();
+		if (MinLength <= 8)
+		{
+			const uint64 Mask = MinLength == 8 ? ~0ull : ((1ull << (MinLength * 8)) - 1);
+			uint64 Key = 0;
+			for (int32 Index = 0; Index < MinLength - 1; ++Index)
+			{
+				Key = (Key << 8) | Bytes[Index];
+			}
+			for (int32 Offset = 0; Offset < NumGrams; ++Offset)
+			{
+				Key = ((Key << 8) | Bytes[Offset + MinLength - 1]) & Mask;
+				Visitor(Offset, Key);
+			}
+			return;
+		}
+
+		uint64 HighestPower = 1;
+		uint64 Key = 0;
+		for (int32 Index = 0; Index < MinLength; ++Index)
+		{
+			Key = Key * RollingHashBase + Bytes[Index];
+			if (Index > 0)
+			{
+				HighestPower *= RollingHashBase;
+			}
+		}
+		for (int32 Offset = 0; Offset < NumGrams; ++Offset)
+		{
+			if (Offset > 0)
+			{
+				Key = (Key - Bytes[Offset - 1] * HighestPower) * RollingHashBase + Bytes[Offset + MinLength - 1];
+			}
+			Visitor(Offset, Key);
+		}
+	}
+}
+
+int32 UDeduplicationFunctionLibrary::FindCommonSubstrings(TArrayView<const uint8> Data1, TArrayView<const uint8> Data2, int32 MinLength)
+{
+	using namespace DeduplicationFunctionLibrary;
+
+	if (MinLength <= 0 || Data1.Num() < MinLength || Data2.Num() < MinLength)
+	{
+		return 0;
+	}
+
 	int32 CommonCount = 0;
+	const uint8* Bytes1 = Data1.GetData();
+	const uint8* Bytes2 = Data2.GetData();
 
-	for (int32 i = 0; i <= Data1.Num() - MinLength; i++)
+	if (MinLength <= 8)
 	{
-		for (int32 j = 0; j <= Data2.Num() - MinLength; j++)
+		TSet<uint64> Grams2;
+		Grams2.Reserve(Data2.Num() - MinLength + 1);
+		ForEachGram(Data2, MinLength, [&Grams2](int32 Offset, uint64 Key) { Grams2.Add(Key); });
+		ForEachGram(Data1, MinLength, [&Grams2, &CommonCount](int32 Offset, uint64 Key) { CommonCount += Grams2.Contains(Key) ? 1 : 0; });
+		return CommonCount;
+	}
+
+	// Hashed grams keep one offset per distinct gram, grams that share a hash are chained and compared byte by byte, so the count is exact.
+	TMap<uint64, int32> FirstOffsetByHash;
+	TArray<int32> NextOffsetWithHash;
+	FirstOffsetByHash.Reserve(Data2.Num() - MinLength + 1);
+	NextOffsetWithHash.Init(INDEX_NONE, Data2.Num() - MinLength + 1);
+
+	auto FindGram = [&](const uint8* Gram, uint64 Key)
 		{
-			bool bMatch = true;
-			for (int32 k = 0; k < MinLength; k++)
+			const int32* Offset = FirstOffsetByHash.Find(Key);
+			for (int32 Candidate = Offset != nullptr ? *Offset : INDEX_NONE; Candidate != INDEX_NONE; Candidate = NextOffsetWithHash[Candidate])
 			{
-				if (Data1[i + k] != Data2[j + k])
+				if (FMemory::Memcmp(Bytes2 + Candidate, Gram, MinLength) == 0)
 				{
-					bMatch = false;
-					break;
+					return true;
 				}
 			}
+			return false;
+		};
 
-			if (bMatch)
+	ForEachGram(Data2, MinLength, [&](int32 Offset, uint64 Key)
+		{
+			if (!FindGram(Bytes2 + Offset, Key))
 			{
-				CommonCount++;
-				break;
+				int32& FirstOffset = FirstOffsetByHash.FindOrAdd(Key, INDEX_NONE);
+				NextOffsetWithHash[Offset] = FirstOffset;
+				FirstOffset = Offset;
 			}
-		}
-	}
+		});
+
+	ForEachGram(Data1, MinLength, [&](int32 Offset, uint64 Key)
+		{
+			CommonCount += FindGram(Bytes1 + Offset, Key) ? 1 : 0;
+		});
 
 	return CommonCount;
 }
 
-int UDeduplicationFunctionLibrary::ComputeLevenshteinDistance(const FString& Str1, const FString& Str2)
+namespace DeduplicationFunctionLibrary
 {
-	const int Len1 = Str1.Len();
-	const int Len2 = Str2.Len();
+	// Pattern match vectors of Myers' algorithm: for every distinct pattern character a bit mask of the positions where it occurs.
+	// Characters are kept in an open addressing table, so no 64K entry table has to be cleared per call.
+	template<int32 InlineChars>
+	struct TPatternMasks
+	{
+		static constexpr uint32 EmptyKey = MAX_uint32;
+		static constexpr int32 InlineSlots = InlineChars * 2;
+		static constexpr int32 InlineWords = (InlineChars + 63) / 64;
+
+		// Patterns of up to InlineChars characters stay in inline storage.
+		TArray<uint32, TInlineAllocator<InlineSlots>> Keys;
+		TArray<uint64, TInlineAllocator<InlineSlots * InlineWords>> Masks;
+		uint32 SlotMask = 0;
+		int32 NumWords = 0;
+
+		void Init(const TCHAR* Pattern, int32 Length)
+		{
+			NumWords = FMath::DivideAndRoundUp(Length, 64);
+			const int32 NumSlots = static_cast<int32>(FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Max(Length * 2, 16))));
+			SlotMask = static_cast<uint32>(NumSlots - 1);
+			Keys.Init(EmptyKey, NumSlots);
+			Masks.Init(0, NumSlots * NumWords);
+
+			for (int32 Index = 0; Index < Length; ++Index)
+			{
+				const int32 Slot = FindOrAddSlot(static_cast<uint32>(Pattern[Index]));
+				Masks[Slot * NumWords + Index / 64] |= 1ull << (Index % 64);
+			}
+		}
 
-	TArray<TArray<int>> Matrix;
-	Matrix.SetNum(Len1 + 1);
-	for (int i = 0; i <= Len1; ++i)
+		int32 FindOrAddSlot(uint32 Key)
+		{
+			uint32 Slot = (Key * 2654435761u) & SlotMask;
+			while (Keys[Slot] != EmptyKey && Keys[Slot] != Key)
+			{
+				Slot = (Slot + 1) & SlotMask;
+			}
+			Keys[Slot] = Key;
+			return static_cast<int32>(Slot);
+		}
+
+		// Returns the masks of the character, or null if it does not occur in the pattern.
+		const uint64* Find(uint32 Key) const
+		{
+			uint32 Slot = (Key * 2654435761u) & SlotMask;
+			while (Keys[Slot] != EmptyKey)
+			{
+				if (Keys[Slot] == Key)
+				{
+					return &Masks[Slot * NumWords];
+				}
+				Slot = (Slot + 1) & SlotMask;
+			}
+			return nullptr;
+		}
+	};
+
+	// One 64 row block of Myers' algorithm for one text character. HorizontalIn is the score delta entering the top of the block,
+	// the delta leaving its bottom row (HighBit) is returned.
+	static FORCEINLINE int32 AdvanceBlock(uint64& Pv, uint64& Mv, uint64 Eq, int32 HorizontalIn, uint64 HighBit)
 	{
-		Matrix[i].SetNum(Len2 + 1);
+		const uint64 Xv = Eq | Mv;
+		if (HorizontalIn < 0)
+		{
+			Eq |= 1;
+		}
+		const uint64 Xh = (((Eq & Pv) + Pv) ^ Pv) | Eq;
+		uint64 Ph = Mv | ~(Xh | Pv);
+		uint64 Mh = Pv & Xh;
+
+		int32 HorizontalOut = 0;
+		if (Ph & HighBit)
+		{
+			HorizontalOut = 1;
+		}
+		else if (Mh & HighBit)
+		{
+			HorizontalOut = -1;
+		}
+
+		Ph <<= 1;
+		Mh <<= 1;
+		if (HorizontalIn < 0)
+		{
+			Mh |= 1;
+		}
+		else if (HorizontalIn > 0)
+		{
+			Ph |= 1;
+		}
+
+		Pv = Mh | ~(Xv | Ph);
+		Mv = Ph & Xv;
+		return HorizontalOut;
 	}
 
-	for (int i = 0; i <= Len1; ++i)
+	// Levenshtein distance of Pattern and Text computed with bit vectors (Myers 1999, Hyyro 2003). Score follows the last row of the DP
+	// matrix. The last row can decrease by at most one per remaining text character, so once Score - Remaining > MaxDistance the
+	// result is known to exceed the bound and MaxDistance + 1 is returned.
+	static int32 ComputeLevenshteinBitParallel(const TCHAR* Pattern, int32 PatternLength, const TCHAR* Text, int32 TextLength, int32 MaxDistance)
 	{
-		Matrix[i][0] = i;
+		if (PatternLength == 0)
+		{
+			return FMath::Min(TextLength, MaxDistance + 1);
+		}
+
+		int32 Score = PatternLength;
+		if (PatternLength <= 64)
+		{
+			// Single word: the common case for asset names, everything stays in registers and on the stack.
+			TPatternMasks<64> PatternMasks;
+			PatternMasks.Init(Pattern, PatternLength);
+
+			const uint64 HighBit = 1ull << (PatternLength - 1);
+			uint64 Pv = ~0ull;
+			uint64 Mv = 0;
+			for (int32 TextIndex = 0; TextIndex < TextLength; ++TextIndex)
+			{
+				const uint64* Eq = PatternMasks.Find(static_cast<uint32>(Text[TextIndex]));
+				Score += AdvanceBlock(Pv, Mv, Eq != nullptr ? *Eq : 0, 1, HighBit);
+				if (Score - (TextLength - TextIndex - 1) > MaxDistance)
+				{
+					return MaxDistance + 1;
+				}
+			}
+			return FMath::Min(Score, MaxDistance + 1);
+		}
+
+		TPatternMasks<128> PatternMasks;
+		PatternMasks.Init(Pattern, PatternLength);
+
+		const int32 NumWords = PatternMasks.NumWords;
+		const uint64 LastHighBit = 1ull << ((PatternLength - 1) % 64);
+		TArray<uint64, TInlineAllocator<8>> Pv;
+		TArray<uint64, TInlineAllocator<8>> Mv;
+		Pv.Init(~0ull, NumWords);
+		Mv.Init(0, NumWords);
+
+		for (int32 TextIndex = 0; TextIndex < TextLength; ++TextIndex)
+		{
+			const uint64* Eq = PatternMasks.Find(static_cast<uint32>(Text[TextIndex]));
+			int32 Horizontal = 1;
+			for (int32 Word = 0; Word < NumWords; ++Word)
+			{
+				const uint64 HighBit = Word == NumWords - 1 ? LastHighBit : (1ull << 63);
+				Horizontal = AdvanceBlock(Pv[Word], Mv[Word], Eq != nullptr ? Eq[Word] : 0, Horizontal, HighBit);
+			}
+			Score += Horizontal;
+			if (Score - (TextLength - TextIndex - 1) > MaxDistance)
+			{
+				return MaxDistance + 1;
+			}
+		}
+		return FMath::Min(Score, MaxDistance + 1);
 	}
-	for (int j = 0; j <= Len2; ++j)
+}
+
+int UDeduplicationFunctionLibrary::ComputeLevenshteinDistance(const FString& Str1, const FString& Str2)
+{
+	return ComputeLevenshteinDistanceBounded(Str1, Str2, MAX_int32 - 1);
+}
+
+int32 UDeduplicationFunctionLibrary::ComputeLevenshteinDistanceBounded(const FString& Str1, const FString& Str2, int32 MaxDistance)
+{
+	// No distance is within a negative bound, so the result always exceeds it.
+	if (MaxDistance < 0)
 	{
-		Matrix[0][j] = j;
+		return MaxDistance + 1;
 	}
 
-	for (int i = 1; i <= Len1; ++i)
+	// The distance is symmetric, the shorter string is the pattern so fewer words are needed.
+	const FString& Pattern = Str1.Len() <= Str2.Len() ? Str1 : Str2;
+	const FString& Text = Str1.Len() <= Str2.Len() ? Str2 : Str1;
+	if (Text.Len() - Pattern.Len() > MaxDistance)
 	{
-		for (int j = 1; j <= Len2; ++j)
-		{
-			int Cost = (Str1[i - 1] == Str2[j - 1]) ? 0 : 1;
-			Matrix[i][j] = FMath::Min3(
-				Matrix[i - 1][j] + 1,
-				Matrix[i][j - 1] + 1,
-				Matrix[i - 1][j - 1] + Cost
-			);
-		}
+		return MaxDistance + 1;
 	}
 
-	return Matrix[Len1][Len2];
+	return DeduplicationFunctionLibrary::ComputeLevenshteinBitParallel(*Pattern, Pattern.Len(), *Text, Text.Len(), MaxDistance);
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,78 @@
+/*
+ * Publisher: AO
+ * Year of Publication: 2026
+ * Copyright AO All Rights Reserved.
+ */
+
+// Interior of one anti-diagonal of the Gotoh alignment. Included by DeduplicationSimdKernels.cpp once per instruction set,
+// inside a namespace that defines FVec with Width lanes of int32. LoadBytes reads Width bytes and widens them to the lanes.
+
+static void ComputeGotohInterior(const FGotohContext& Context, int32 Diagonal, int32 Begin, int32 End, const FGotohDiagonal& D2, const FGotohDiagonal& D1, FGotohDiagonal& Cur)
+{
+	const FDeduplicationGotohScoring& Scoring = Context.Scoring;
+	const FVec::FRegister GapStart = FVec::Splat(Scoring.GapOpen + Scoring.GapExtend);
+	const FVec::FRegister GapExtend = FVec::Splat(Scoring.GapExtend);
+	const FVec::FRegister MatchScore = FVec::Splat(Scoring.MatchScore);
+	const FVec::FRegister MismatchScore = FVec::Splat(Scoring.MismatchScore);
+	const FVec::FRegister One = FVec::Splat(1);
+
+	const uint8* A = Context.A;
+	const uint8* ReversedB = Context.ReversedB + Context.LengthB - Diagonal;
+
+	// Pointers to the row 0 slot would point outside the band storage, so the loop adds these offsets to the row instead.
+	const int32 D1Offset = -D1.FirstRow;
+	const int32 D2Offset = -D2.FirstRow;
+	const int32 CurOffset = -Cur.FirstRow;
+
+	int32 Row = Begin;
+	for (; Row + FVec::Width - 1 <= End; Row += FVec::Width)
+	{
+		const int32 Up = Row - 1 + D1Offset;
+		const int32 Left = Row + D1Offset;
+		const int32 Diag = Row - 1 + D2Offset;
+		const int32 Target = Row + CurOffset;
+
+		// E: gap in B, comes from the cell above (Row - 1 on the previous diagonal).
+		const FVec::FRegister FromHToE = FVec::Add(FVec::Load(D1.HScore + Up), GapStart);
+		const FVec::FRegister FromEToE = FVec::Add(FVec::Load(D1.EScore + Up), GapExtend);
+		const FVec::FRegister EFromH = FVec::Greater(FromHToE, FromEToE);
+		FVec::Store(Cur.EScore + Target, FVec::Select(EFromH, FromHToE, FromEToE));
+		FVec::Store(Cur.EMatches + Target, FVec::Select(EFromH, FVec::Load(D1.HMatches + Up), FVec::Load(D1.EMatches + Up)));
+		FVec::Store(Cur.ELength + Target, FVec::Add(FVec::Select(EFromH, FVec::Load(D1.HLength + Up), FVec::Load(D1.ELength + Up)), One));
+
+		// F: gap in A, comes from the cell on the left (same row on the previous diagonal).
+		const FVec::FRegister FromHToF = FVec::Add(FVec::Load(D1.HScore + Left), GapStart);
+		const FVec::FRegister FromFToF = FVec::Add(FVec::Load(D1.FScore + Left), GapExtend);
+		const FVec::FRegister FFromH = FVec::Greater(FromHToF, FromFToF);
+		FVec::Store(Cur.FScore + Target, FVec::Select(FFromH, FromHToF, FromFToF));
+		FVec::Store(Cur.FMatches + Target, FVec::Select(FFromH, FVec::Load(D1.HMatches + Left), FVec::Load(D1.FMatches + Left)));
+		FVec::Store(Cur.FLength + Target, FVec::Add(FVec::Select(FFromH, FVec::Load(D1.HLength + Left), FVec::Load(D1.FLength + Left)), One));
+
+		// H: match or mismatch, comes from the best of H, E, F on the diagonal two anti-diagonals back.
+		FVec::FRegister BestScore = FVec::Load(D2.HScore + Diag);
+		FVec::FRegister BestMatches = FVec::Load(D2.HMatches + Diag);
+		FVec::FRegister BestLength = FVec::Load(D2.HLength + Diag);
+
+		const FVec::FRegister DiagE = FVec::Load(D2.EScore + Diag);
+		const FVec::FRegister UseE = FVec::Greater(DiagE, BestScore);
+		BestScore = FVec::Select(UseE, DiagE, BestScore);
+		BestMatches = FVec::Select(UseE, FVec::Load(D2.EMatches + Diag), BestMatches);
+		BestLength = FVec::Select(UseE, FVec::Load(D2.ELength + Diag), BestLength);
+
+		const FVec::FRegister DiagF = FVec::Load(D2.FScore + Diag);
+		const FVec::FRegister UseF = FVec::Greater(DiagF, BestScore);
+		BestScore = FVec::Select(UseF, DiagF, BestScore);
+		BestMatches = FVec::Select(UseF, FVec::Load(D2.FMatches + Diag), BestMatches);
+		BestLength = FVec::Select(UseF, FVec::Load(D2.FLength + Diag), BestLength);
+
+		const FVec::FRegister IsMatch = FVec::Equal(FVec::LoadBytes(A + Row - 1), FVec::LoadBytes(ReversedB + Row));
+		FVec::Store(Cur.HScore + Target, FVec::Add(BestScore, FVec::Select(IsMatch, MatchScore, MismatchScore)));
+		FVec::Store(Cur.HMatches + Target, FVec::Add(BestMatches, FVec::And(IsMatch, One)));
+		FVec::Store(Cur.HLength + Target, FVec::Add(BestLength, One));
+	}
+
+	for (; Row <= End; ++Row)
+	{
+		ComputeGotohCell(Context, Diagonal, Row, D2, D1, Cur);
+	}
+}
@@ -10,6 +10,9 @@
 #include "DeduplicateObjects/EqualNameDeduplication.h"
 #include "DeduplicateObjects/EqualSizeDeduplication.h"
 #include "DeduplicationFunctionLibrary.h"
+#include "DeduplicationFingerprintCache.h"
+#include "Algo/StableSort.h"
+#include "Async/TaskGraphInterfaces.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 #include "HAL/PlatformFilemanager.h"
@@ -47,7 +50,12 @@ void UDeduplicationManager::EndDeduplicateAssetsAsync(TArray<FDuplicateGroup> Ne
 	}
 	
 	FScopeLock Lock(&EndDeduplicationLock);
-	DeduplicateGroups.Append(NewDeduplicateGroups);
+	// Only the manager's own copies are compacted, other listeners of the algorithm still receive the assets.
+	for (FDuplicateGroup& NewGroup : NewDeduplicateGroups)
+	{
+		AssetTable.CompactGroup(NewGroup);
+	}
+	DeduplicateGroups.Append(MoveTemp(NewDeduplicateGroups));
 	DeduplicationAlgorithmsInWork.Remove(DeduplicationAlgorithm);
 	DeduplicationAlgorithm->OnDeduplicationCompleted.RemoveAll(this);
 	CompleteProgress += DeduplicationAlgorithm->AlgorithmComplexity;
@@ -65,7 +73,11 @@ void UDeduplicationManager::EndEarlyDeduplicateAssetsAsync(TArray<FDuplicateGrou
 	}
 	
 	FScopeLock Lock(&EndEarlyDeduplicationLock);
-	EarlyDeduplicateGroups.Append(NewDeduplicateGroups);
+	for (FDuplicateGroup& NewGroup : NewDeduplicateGroups)
+	{
+		AssetTable.CompactGroup(NewGroup);
+	}
+	EarlyDeduplicateGroups.Append(MoveTemp(NewDeduplicateGroups));
 	EarlyCheckAlgorithm->OnDeduplicationCompleted.RemoveAll(this);
 	CompleteProgress += EarlyCheckAlgorithm->AlgorithmComplexity;
 	EarlyCheckDeduplicationAlgorithmsInWork.Remove(EarlyCheckAlgorithm);
@@ -82,13 +94,27 @@ void UDeduplicationManager::StartAnalyzeAssetsAsync(const TArray<FAssetData>& As
 	bIsAnalyze = true;
 	bCompleteAnalyze = false;
 	AnalyzedClusters.Empty();
-	DeduplicationAlgorithmsInWork.Empty();
-	EarlyCheckDeduplicationAlgorithmsInWork.Empty();
-	EarlyDeduplicateGroups.Empty();
-	DeduplicateGroups.Empty();
 	SummaryComplexity = 0.0f;
 	CompleteProgress = 0.0f;
 
+	{
+		// Algorithms of a stopped run may still be finishing, they touch the groups and the asset table only under these locks.
+		FScopeLock Lock(&EndDeduplicationLock);
+		FScopeLock EarlyLock(&EndEarlyDeduplicationLock);
+		DeduplicationAlgorithmsInWork.Empty();
+		EarlyCheckDeduplicationAlgorithmsInWork.Empty();
+		EarlyDeduplicateGroups.Empty();
+		DeduplicateGroups.Empty();
+
+		AssetTable.Reset();
+		for (const FAssetData& Asset : AssetsCopy)
+		{
+			AssetTable.Intern(Asset);
+		}
+	}
+
+	FDeduplicationFingerprintCache::Get().ResetFingerprintKeys();
+
 	Async(EAsyncExecution::ThreadPool, [this, AssetsCopy = MoveTemp(AssetsCopy)]()
 		{
 			if (bShouldStop.GetValue() != 0)
@@ -275,44 +301,103 @@ void UDeduplicationManager::StartDeduplicationAsyncAfterEarlyCheck()
 		return;
 	}
 	
-	for (UDeduplicateObject* Algorithm : DeduplicationAlgorithms)
-	{
-		if (bShouldStop.GetValue() != 0)
+	AsyncTask(ENamedThreads::GameThread, [this]()
 		{
-			break;
-		}
-		if (!Algorithm) continue;
-
-		AsyncTask(ENamedThreads::GameThread, [this, Algorithm]() mutable
-			{
 			if (bShouldStop.GetValue() != 0)
 			{
 				return;
 			}
-			
-			for (const FDuplicateGroup& DuplicateGroup : EarlyDeduplicateGroups)
+
+			// Early groups are spread over a few batches per algorithm, largest first onto the lightest batch.
+			// Each batch is processed by one algorithm instance, instead of duplicating an instance for every early group.
+			const int32 NumWorkers = MaxConcurrentTasks > 0 ? MaxConcurrentTasks : FTaskGraphInterface::Get().GetNumWorkerThreads();
+			const int32 NumBatches = FMath::Clamp(NumWorkers, 1, FMath::Max(1, EarlyDeduplicateGroups.Num()));
+
+			TArray<int32> GroupOrder;
+			GroupOrder.Reserve(EarlyDeduplicateGroups.Num());
+			for (int32 GroupIndex = 0; GroupIndex < EarlyDeduplicateGroups.Num(); ++GroupIndex)
 			{
-				if (bShouldStop.GetValue() != 0)
+				GroupOrder.Add(GroupIndex);
+			}
+			Algo::StableSort(GroupOrder, [this](int32 Left, int32 Right)
 				{
-					break;
+					return EarlyDeduplicateGroups[Left].NumAssets() > EarlyDeduplicateGroups[Right].NumAssets();
+				});
+
+			TArray<TArray<int32>> BatchGroupIndices;
+			BatchGroupIndices.SetNum(NumBatches);
+			TArray<int64> BatchLoads;
+			BatchLoads.Init(0, NumBatches);
+			for (int32 GroupIndex : GroupOrder)
+			{
+				int32 LightestBatch = 0;
+				for (int32 BatchIndex = 1; BatchIndex < NumBatches; ++BatchIndex)
+				{
+					if (BatchLoads[BatchIndex] < BatchLoads[LightestBatch])
+					{
+						LightestBatch = BatchIndex;
+					}
 				}
-				UDeduplicateObject* NewAlgorithm = DuplicateObject(Algorithm, this);
-				NewAlgorithm->OwnerManager = this;
-				NewAlgorithm->OnDeduplicationProgressCompleted.AddUObject(this, &UDeduplicationManager::BindUpdateDeduplicationProgressCompleted);
-				NewAlgorithm->OnDeduplicationCompleted.AddUObject(this, &UDeduplicationManager::EndDeduplicateAssetsAsync);
-				DeduplicationAlgorithmsInWork.Add(NewAlgorithm);
+				const int64 GroupSize = EarlyDeduplicateGroups[GroupIndex].NumAssets();
+				BatchLoads[LightestBatch] += GroupSize * GroupSize;
+				BatchGroupIndices[LightestBatch].Add(GroupIndex);
+			}
 
-				Async(EAsyncExecution::ThreadPool, [Algorithm, DuplicateGroup, NewAlgorithm, this]()
+			TArray<TPair<UDeduplicateObject*, int32>> Launches;
+			{
+				FScopeLock Lock(&EndDeduplicationLock);
+				for (UDeduplicateObject* Algorithm : DeduplicationAlgorithms)
+				{
+					if (!Algorithm) continue;
+
+					for (int32 BatchIndex = 0; BatchIndex < NumBatches; ++BatchIndex)
 					{
-						if (bShouldStop.GetValue() == 0)
+						if (BatchGroupIndices[BatchIndex].Num() == 0)
 						{
-							NewAlgorithm->FindDuplicates(DuplicateGroup.DuplicateAssets);
+							continue;
 						}
+
+						UDeduplicateObject* NewAlgorithm = DuplicateObject(Algorithm, this);
+						NewAlgorithm->OwnerManager = this;
+						NewAlgorithm->OnDeduplicationProgressCompleted.AddUObject(this, &UDeduplicationManager::BindUpdateDeduplicationProgressCompleted);
+						NewAlgorithm->OnDeduplicationCompleted.AddUObject(this, &UDeduplicationManager::EndDeduplicateAssetsAsync);
+						DeduplicationAlgorithmsInWork.Add(NewAlgorithm);
+						Launches.Emplace(NewAlgorithm, BatchIndex);
+					}
+				}
+			}
+
+			if (Launches.Num() == 0)
+			{
+				Async(EAsyncExecution::ThreadPool, [this]()
+					{
+						StartCreateClusters();
 					});
+				return;
 			}
-			});
 
-	}
+			for (const TPair<UDeduplicateObject*, int32>& Launch : Launches)
+			{
+				UDeduplicateObject* NewAlgorithm = Launch.Key;
+				TArray<int32> GroupIndices = BatchGroupIndices[Launch.Value];
+				Async(EAsyncExecution::ThreadPool, [this, NewAlgorithm, GroupIndices = MoveTemp(GroupIndices)]()
+					{
+						if (bShouldStop.GetValue() == 0)
+						{
+							TArray<TArray<FAssetData>> AssetGroups;
+							AssetGroups.SetNum(GroupIndices.Num());
+							{
+								FScopeLock Lock(&EndEarlyDeduplicationLock);
+								for (int32 Index = 0; Index < GroupIndices.Num() && EarlyDeduplicateGroups.IsValidIndex(GroupIndices[Index]); ++Index)
+								{
+									AssetTable.GetGroupAssets(EarlyDeduplicateGroups[GroupIndices[Index]], AssetGroups[Index]);
+								}
+							}
+							NewAlgorithm->FindDuplicatesInGroups(AssetGroups);
+						}
+					});
+			}
+		});
 }
 
 
@@ -323,10 +408,27 @@ void UDeduplicationManager::StartCreateClusters()
 		return;
 	}
 	
-	TArray<FDuplicateCluster> ResultClusters;
 	SetProgress(0.99);
 
+	// Clusters are addressed by asset table IDs, so merging a group costs O(GroupSize^2) integer lookups
+	// instead of linear scans over all clusters and all their duplicates. FAssetData is only materialized at the end.
+	struct FClusterBuilder
+	{
+		int32 CenterAssetId = INDEX_NONE;
+		float ClusterScore = 0.0f;
+		bool bScored = false;
+		TArray<TPair<int32, float>> Duplicates;
+		TMap<int32, int32> DuplicateIndexByAssetId;
+	};
+
+	TArray<FClusterBuilder> ClusterBuilders;
+	TArray<int32> ClusterIndexByAssetId;
+	ClusterIndexByAssetId.Init(INDEX_NONE, AssetTable.Num());
+
+	const int32 ProgressUpdateInterval = 1024;
 	int Counter = 0;
+	TArray<int32> GroupAssetIds;
+	TArray<int32> GroupClusterIndices;
 	for (const FDuplicateGroup& DuplicateGroup : DeduplicateGroups)
 	{
 		if (bShouldStop.GetValue() != 0)
@@ -336,82 +438,94 @@ void UDeduplicationManager::StartCreateClusters()
 		
 		const float GroupScore = DuplicateGroup.ConfidenceScore;
 		Counter++;
-		SetProgress(0.99 + static_cast<float>(Counter)/ static_cast<float>(DeduplicateGroups.Num()) * 0.01);
-		for (const FAssetData& CenterAsset : DuplicateGroup.DuplicateAssets)
+		if (Counter % ProgressUpdateInterval == 0)
 		{
-			FDuplicateCluster* FoundCluster = ResultClusters.FindByKey(CenterAsset);
+			SetProgress(0.99 + static_cast<float>(Counter)/ static_cast<float>(DeduplicateGroups.Num()) * 0.01);
+		}
 
-			if (FoundCluster == nullptr)
-			{
-				FDuplicateCluster NewCluster;
-				NewCluster.AssetData = CenterAsset;
-				NewCluster.ClusterScore = GroupScore;
+		AssetTable.GetGroupAssetIds(DuplicateGroup, GroupAssetIds);
+		while (ClusterIndexByAssetId.Num() < AssetTable.Num())
+		{
+			ClusterIndexByAssetId.Add(INDEX_NONE);
+		}
 
-				for (const FAssetData& OtherAsset : DuplicateGroup.DuplicateAssets)
-				{
-					if (OtherAsset == CenterAsset)
-						continue;
+		GroupClusterIndices.Reset(GroupAssetIds.Num());
+		for (int32 AssetId : GroupAssetIds)
+		{
+			int32& ClusterIndex = ClusterIndexByAssetId[AssetId];
+			if (ClusterIndex == INDEX_NONE)
+			{
+				ClusterIndex = ClusterBuilders.Num();
+				ClusterBuilders.AddDefaulted_GetRef().CenterAssetId = AssetId;
+			}
+			GroupClusterIndices.Add(ClusterIndex);
+		}
 
-					FDeduplicationAssetStruct Entry;
-					Entry.DuplicateAsset = OtherAsset;
-					Entry.DeduplicationAssetScore = GroupScore;
-					NewCluster.DuplicateAssets.Add(MoveTemp(Entry));
-				}
+		for (int32 CenterIndex = 0; CenterIndex < GroupClusterIndices.Num(); ++CenterIndex)
+		{
+			FClusterBuilder& Cluster = ClusterBuilders[GroupClusterIndices[CenterIndex]];
+			const int32 CenterAssetId = GroupAssetIds[CenterIndex];
 
-				ResultClusters.Add(MoveTemp(NewCluster));
+			// A cluster seen for the first time takes the group score, an existing one combines with it.
+			if (!Cluster.bScored)
+			{
+				Cluster.ClusterScore = GroupScore;
+				Cluster.bScored = true;
+			}
+			else if (CombinationScoreMethod == ECombinationScoreMethod::Add)
+			{
+				Cluster.ClusterScore += GroupScore;
 			}
 			else
 			{
-				FDuplicateCluster& Cluster = *FoundCluster;
+				Cluster.ClusterScore *= GroupScore;
+			}
 
-				if (CombinationScoreMethod == ECombinationScoreMethod::Add)
-				{
-					Cluster.ClusterScore += GroupScore;
-				}
-				else
+			for (int32 OtherAssetId : GroupAssetIds)
+			{
+				if (OtherAssetId == CenterAssetId)
 				{
-					Cluster.ClusterScore *= GroupScore;
+					continue;
 				}
 
-				for (const FAssetData& OtherAsset : DuplicateGroup.DuplicateAssets)
+				if (const int32* FoundDuplicateIndex = Cluster.DuplicateIndexByAssetId.Find(OtherAssetId))
 				{
-					if (OtherAsset == CenterAsset)
-						continue;
+					float& ExistingScore = Cluster.Duplicates[*FoundDuplicateIndex].Value;
 
-					int32 FoundIndex = INDEX_NONE;
-					for (int32 i = 0; i < Cluster.DuplicateAssets.Num(); ++i)
-					{
-						if (Cluster.DuplicateAssets[i].DuplicateAsset == OtherAsset)
-						{
-							FoundIndex = i;
-							break;
-						}
-					}
-
-					if (FoundIndex != INDEX_NONE)
+					if (CombinationScoreMethod == ECombinationScoreMethod::Add)
 					{
-						float& ExistingScore = Cluster.DuplicateAssets[FoundIndex].DeduplicationAssetScore;
-
-						if (CombinationScoreMethod == ECombinationScoreMethod::Add)
-						{
-							ExistingScore += GroupScore;
-						}
-						else
-						{
-							ExistingScore *= GroupScore;
-						}
+						ExistingScore += GroupScore;
 					}
 					else
 					{
-						FDeduplicationAssetStruct NewEntry;
-						NewEntry.DuplicateAsset = OtherAsset;
-						NewEntry.DeduplicationAssetScore = GroupScore;
-						Cluster.DuplicateAssets.Add(MoveTemp(NewEntry));
+						ExistingScore *= GroupScore;
 					}
 				}
+				else
+				{
+					Cluster.DuplicateIndexByAssetId.Add(OtherAssetId, Cluster.Duplicates.Num());
+					Cluster.Duplicates.Emplace(OtherAssetId, GroupScore);
+				}
 			}
 		}
 	}
+
+	TArray<FDuplicateCluster> ResultClusters;
+	ResultClusters.Reserve(ClusterBuilders.Num());
+	for (const FClusterBuilder& Builder : ClusterBuilders)
+	{
+		FDuplicateCluster& Cluster = ResultClusters.AddDefaulted_GetRef();
+		Cluster.AssetData = AssetTable.GetAsset(Builder.CenterAssetId);
+		Cluster.ClusterScore = Builder.ClusterScore;
+		Cluster.DuplicateAssets.Reserve(Builder.Duplicates.Num());
+		for (const TPair<int32, float>& Duplicate : Builder.Duplicates)
+		{
+			FDeduplicationAssetStruct Entry;
+			Entry.DuplicateAsset = AssetTable.GetAsset(Duplicate.Key);
+			Entry.DeduplicationAssetScore = Duplicate.Value;
+			Cluster.DuplicateAssets.Add(MoveTemp(Entry));
+		}
+	}
 	SetProgress(0.9999);
 
 	/*
@@ -457,6 +571,8 @@ void UDeduplicationManager::StartCreateClusters()
 		Count++;
 	}*/
 
+	FDeduplicationFingerprintCache::Get().Flush();
+
 	if (bShouldStop.GetValue() != 0)
 	{
 		AsyncTask(ENamedThreads::GameThread, [this]()
@@ -968,6 +1084,8 @@ void UDeduplicationManager::StopAnalyze()
 		FScopeLock Lock(&EndEarlyDeduplicationLock);
 		EarlyCheckDeduplicationAlgorithmsInWork.Empty();
 	}
+
+	FDeduplicationFingerprintCache::Get().Flush();
 	
 	ProgressValue = 0.0f;
 }
\ No newline at end of file
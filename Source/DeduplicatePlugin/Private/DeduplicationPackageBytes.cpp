@@ -0,0 +1,264 @@
+/*
+ * Publisher: AO
+ * Year of Publication: 2026
+ * Copyright AO All Rights Reserved.
+ */
+
+#include "DeduplicationPackageBytes.h"
+#include "Algo/Sort.h"
+#include "Serialization/MemoryReader.h"
+#include "UObject/NameTypes.h"
+#include "UObject/ObjectResource.h"
+#include "UObject/PackageFileSummary.h"
+#include "UObject/PropertyTag.h"
+#include "UObject/UnrealNames.h"
+
+namespace DeduplicationPackageBytes
+{
+	// Bytes of control data the tag stream of an export may start with, depending on the package version.
+	static const int32 MaxTagStreamPrefix = 2;
+
+	// Reads package data like the linker does: FNames are name map references, and the position of every one read is recorded.
+	class FNameMapReader : public FMemoryReaderView
+	{
+	public:
+		FNameMapReader(TArrayView<const uint8> InBytes, const FPackageFileSummary& Summary, TArrayView<const FName> InNames)
+			: FMemoryReaderView(InBytes, /*bIsPersistent=*/ true)
+			, Names(InNames)
+		{
+			SetUEVer(Summary.GetFileVersionUE());
+			SetLicenseeUEVer(Summary.GetFileVersionLicenseeUE());
+			SetCustomVersions(Summary.GetCustomVersionContainer());
+		}
+
+		using FMemoryReaderView::operator<<;
+
+		virtual FArchive& operator<<(FName& Name) override
+		{
+			const int64 Offset = Tell();
+			int32 NameIndex = 0;
+			int32 NameNumber = 0;
+			*this << NameIndex;
+			*this << NameNumber;
+			if (IsError() || !Names.IsValidIndex(NameIndex))
+			{
+				SetError();
+				Name = NAME_None;
+				return *this;
+			}
+
+			Name = FName(Names[NameIndex], NameNumber);
+			NameReferences.Emplace(Offset, NameIndex);
+			return *this;
+		}
+
+		// File offset and name map index of every FName read since the last reset.
+		TArray<TPair<int64, int32>> NameReferences;
+
+	private:
+		TArrayView<const FName> Names;
+	};
+
+	static bool ReadSummary(TArrayView<const uint8> PackageBytes, FPackageFileSummary& OutSummary)
+	{
+		if (PackageBytes.Num() < static_cast<int32>(sizeof(uint32)))
+		{
+			return false;
+		}
+
+		uint32 Tag = 0;
+		FMemory::Memcpy(&Tag, PackageBytes.GetData(), sizeof(Tag));
+		if (Tag != PACKAGE_FILE_TAG)
+		{
+			return false;
+		}
+
+		FMemoryReaderView Reader(PackageBytes, /*bIsPersistent=*/ true);
+		Reader << OutSummary;
+		return !Reader.IsError() && OutSummary.Tag == PACKAGE_FILE_TAG;
+	}
+
+	static bool GetExportRegion(const FPackageFileSummary& Summary, int64 FileSize, int64& OutOffset, int64& OutSize)
+	{
+		const int64 Begin = Summary.TotalHeaderSize;
+		// Inline bulk data and the package trailer hold texture mips, mesh buffers and sound payloads, so they are kept.
+		if (Begin <= 0 || Begin >= FileSize)
+		{
+			return false;
+		}
+
+		OutOffset = Begin;
+		OutSize = FileSize - Begin;
+		return true;
+	}
+
+	// Name map entries are read with the package version, so the serialized name hashes are skipped correctly.
+	static bool ReadNameMap(TArrayView<const uint8> PackageBytes, const FPackageFileSummary& Summary, TArray<FName>& OutNames)
+	{
+		const int64 FileSize = PackageBytes.Num();
+		if (Summary.NameCount <= 0 || Summary.NameOffset <= 0 || Summary.NameOffset >= FileSize)
+		{
+			return false;
+		}
+
+		FMemoryReaderView Reader(PackageBytes, /*bIsPersistent=*/ true);
+		Reader.SetUEVer(Summary.GetFileVersionUE());
+		Reader.SetLicenseeUEVer(Summary.GetFileVersionLicenseeUE());
+		Reader.Seek(Summary.NameOffset);
+
+		// Every entry takes at least its length prefix, a corrupt count cannot reserve more than the file could hold.
+		OutNames.Reserve(static_cast<int32>(FMath::Min<int64>(Summary.NameCount, (FileSize - Summary.NameOffset) / sizeof(int32))));
+		for (int32 NameIndex = 0; NameIndex < Summary.NameCount && !Reader.IsError(); ++NameIndex)
+		{
+			FNameEntrySerialized NameEntry(ENAME_LinkerConstructor);
+			Reader << NameEntry;
+			OutNames.Emplace(NameEntry);
+		}
+		return !Reader.IsError();
+	}
+
+	static bool ReadExportMap(FNameMapReader& Reader, const FPackageFileSummary& Summary, int64 FileSize, TArray<FObjectExport>& OutExports)
+	{
+		if (Summary.ExportCount <= 0 || Summary.ExportOffset <= 0 || Summary.ExportOffset >= FileSize)
+		{
+			return false;
+		}
+
+		Reader.Seek(Summary.ExportOffset);
+		OutExports.Reserve(static_cast<int32>(FMath::Min<int64>(Summary.ExportCount, (FileSize - Summary.ExportOffset) / sizeof(int32))));
+		for (int32 ExportIndex = 0; ExportIndex < Summary.ExportCount && !Reader.IsError(); ++ExportIndex)
+		{
+			Reader << OutExports.AddDefaulted_GetRef();
+		}
+		return !Reader.IsError();
+	}
+
+	// Walks the tagged properties from Begin up to the None tag. On success the reader holds the positions of the FNames in the tag
+	// headers, and of the values of name properties, which are FNames as well.
+	static bool ReadTaggedPropertyNames(FNameMapReader& Reader, int64 Begin, int64 End)
+	{
+		Reader.ClearError();
+		Reader.NameReferences.Reset();
+		Reader.Seek(Begin);
+		while (Reader.Tell() < End)
+		{
+			FPropertyTag Tag;
+			Reader << Tag;
+			if (Reader.IsError() || Reader.Tell() > End)
+			{
+				return false;
+			}
+			if (Tag.Name.IsNone())
+			{
+				return true;
+			}
+			if (Tag.Size < 0 || Reader.Tell() + Tag.Size > End)
+			{
+				return false;
+			}
+
+			if (Tag.Type == NAME_NameProperty && Tag.Size == 2 * sizeof(int32))
+			{
+				FName Value;
+				Reader << Value;
+			}
+			else
+			{
+				Reader.Seek(Reader.Tell() + Tag.Size);
+			}
+		}
+		return false;
+	}
+}
+
+bool FDeduplicationPackageBytes::FindExportRegion(TArrayView<const uint8> PackageBytes, int64& OutOffset, int64& OutSize)
+{
+	using namespace DeduplicationPackageBytes;
+
+	FPackageFileSummary Summary;
+	return ReadSummary(PackageBytes, Summary) && GetExportRegion(Summary, PackageBytes.Num(), OutOffset, OutSize);
+}
+
+bool FDeduplicationPackageBytes::ExtractNormalizedExports(TArrayView<const uint8> PackageBytes, TArray<uint8>& OutBytes)
+{
+	using namespace DeduplicationPackageBytes;
+
+	FPackageFileSummary Summary;
+	int64 ExportOffset = 0;
+	int64 ExportSize = 0;
+	if (!ReadSummary(PackageBytes, Summary) || !GetExportRegion(Summary, PackageBytes.Num(), ExportOffset, ExportSize))
+	{
+		return false;
+	}
+
+	OutBytes.SetNumUninitialized(static_cast<int32>(ExportSize));
+	FMemory::Memcpy(OutBytes.GetData(), PackageBytes.GetData() + ExportOffset, ExportSize);
+
+	// Unversioned properties have no tags, and without the name and export maps no name can be located. The exports are kept as they are.
+	TArray<FName> Names;
+	if ((Summary.GetPackageFlags() & PKG_UnversionedProperties) != 0 || !ReadNameMap(PackageBytes, Summary, Names))
+	{
+		return true;
+	}
+
+	FNameMapReader Reader(PackageBytes, Summary, Names);
+	TArray<FObjectExport> Exports;
+	if (!ReadExportMap(Reader, Summary, PackageBytes.Num(), Exports))
+	{
+		return true;
+	}
+
+	// The same set of names gets the same indices in every package, however the name map happens to be ordered.
+	TArray<int32> SortedNames;
+	SortedNames.SetNumUninitialized(Names.Num());
+	for (int32 NameIndex = 0; NameIndex < Names.Num(); ++NameIndex)
+	{
+		SortedNames[NameIndex] = NameIndex;
+	}
+	Algo::Sort(SortedNames, [&Names](int32 A, int32 B) { return Names[A].Compare(Names[B]) < 0; });
+
+	TArray<int32> CanonicalIndices;
+	CanonicalIndices.SetNumUninitialized(Names.Num());
+	for (int32 SortedIndex = 0; SortedIndex < SortedNames.Num(); ++SortedIndex)
+	{
+		CanonicalIndices[SortedNames[SortedIndex]] = SortedIndex;
+	}
+
+	const int64 ExportEnd = ExportOffset + ExportSize;
+	for (const FObjectExport& Export : Exports)
+	{
+		const int64 SerialBegin = Export.SerialOffset;
+		const int64 SerialEnd = Export.SerialOffset + Export.SerialSize;
+		if (SerialBegin < ExportOffset || Export.SerialSize <= 0 || SerialEnd > ExportEnd)
+		{
+			continue;
+		}
+
+		// Packages that record where the script properties are stored limit the walk to them, older ones start at the export.
+		int64 Begin = SerialBegin;
+		int64 End = SerialEnd;
+		if (Export.ScriptSerializationEndOffset > Export.ScriptSerializationStartOffset)
+		{
+			Begin = SerialBegin + Export.ScriptSerializationStartOffset;
+			End = FMath::Min(SerialBegin + Export.ScriptSerializationEndOffset, SerialEnd);
+		}
+
+		// A version dependent control byte may precede the first tag. Only a stream that parses up to its None tag is remapped,
+		// anything else is left untouched.
+		for (int32 Prefix = 0; Prefix <= MaxTagStreamPrefix; ++Prefix)
+		{
+			if (!ReadTaggedPropertyNames(Reader, Begin + Prefix, End))
+			{
+				continue;
+			}
+
+			for (const TPair<int64, int32>& Reference : Reader.NameReferences)
+			{
+				FMemory::Memcpy(OutBytes.GetData() + (Reference.Key - ExportOffset), &CanonicalIndices[Reference.Value], sizeof(int32));
+			}
+			break;
+		}
+	}
+
+	return true;
+}
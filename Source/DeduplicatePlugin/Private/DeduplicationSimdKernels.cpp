@@ -0,0 +1,626 @@
+/*
+ * Publisher: AO
+ * Year of Publication: 2026
+ * Copyright AO All Rights Reserved.
+ */
+
+#include "DeduplicationSimdKernels.h"
+#include "HAL/PlatformMisc.h"
+
+#if PLATFORM_CPU_X86_FAMILY && PLATFORM_ENABLE_VECTORINTRINSICS
+#define DEDUPLICATION_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define DEDUPLICATION_SIMD_X86 0
+#endif
+
+#if PLATFORM_CPU_ARM_FAMILY && PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+#define DEDUPLICATION_SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define DEDUPLICATION_SIMD_NEON 0
+#endif
+
+// AVX2 code is compiled for that target only and reached after the runtime check in GetInstructionSet. MSVC needs no attribute.
+#if defined(__clang__)
+#define DEDUPLICATION_AVX2_BEGIN _Pragma("clang attribute push(__attribute__((target(\"avx2\"))), apply_to = function)")
+#define DEDUPLICATION_AVX2_END _Pragma("clang attribute pop")
+#else
+#define DEDUPLICATION_AVX2_BEGIN
+#define DEDUPLICATION_AVX2_END
+#endif
+
+namespace DeduplicationSimdKernels
+{
+	static const int32 GotohNegInf = INT32_MIN / 4;
+
+	// One anti-diagonal of the H, E and F matrices. Only the rows of the band and one row on each side of it are stored, row Row
+	// lives in slot Row - FirstRow. Every cell carries its score and the match count and length of the backtrace path starting in it,
+	// the same values the scalar kernel of UEqualNeedlemanWunschDataDeduplication keeps per row.
+	struct FGotohDiagonal
+	{
+		TArray<int32> Storage;
+		int32 FirstRow = 0;
+		int32* HScore = nullptr;
+		int32* HMatches = nullptr;
+		int32* HLength = nullptr;
+		int32* EScore = nullptr;
+		int32* EMatches = nullptr;
+		int32* ELength = nullptr;
+		int32* FScore = nullptr;
+		int32* FMatches = nullptr;
+		int32* FLength = nullptr;
+
+		void Init(int32 NumCells)
+		{
+			Storage.SetNumUninitialized(NumCells * 9);
+			int32* Data = Storage.GetData();
+			for (int32** Column : { &HScore, &HMatches, &HLength, &EScore, &EMatches, &ELength, &FScore, &FMatches, &FLength })
+			{
+				*Column = Data;
+				Data += NumCells;
+			}
+			for (int32 Cell = 0; Cell < NumCells; ++Cell)
+			{
+				ResetSlot(Cell);
+			}
+		}
+
+		FORCEINLINE int32 Slot(int32 Row) const
+		{
+			return Row - FirstRow;
+		}
+
+		void ResetSlot(int32 Slot)
+		{
+			HScore[Slot] = GotohNegInf;
+			EScore[Slot] = GotohNegInf;
+			FScore[Slot] = GotohNegInf;
+			HMatches[Slot] = HLength[Slot] = 0;
+			EMatches[Slot] = ELength[Slot] = 0;
+			FMatches[Slot] = FLength[Slot] = 0;
+		}
+
+		void ResetCell(int32 Row)
+		{
+			ResetSlot(Slot(Row));
+		}
+	};
+
+	struct FGotohContext
+	{
+		const uint8* A = nullptr;
+		const uint8* ReversedB = nullptr;
+		int32 LengthA = 0;
+		int32 LengthB = 0;
+		FDeduplicationGotohScoring Scoring;
+	};
+
+	using FGotohInteriorFunction = void (*)(const FGotohContext&, int32, int32, int32, const FGotohDiagonal&, const FGotohDiagonal&, FGotohDiagonal&);
+
+	// Cell (Row, Diagonal - Row). Up is Row - 1 and left is Row on the previous anti-diagonal, the diagonal neighbour is Row - 1 two back.
+	static void ComputeGotohCell(const FGotohContext& Context, int32 Diagonal, int32 Row, const FGotohDiagonal& D2, const FGotohDiagonal& D1, FGotohDiagonal& Cur)
+	{
+		const FDeduplicationGotohScoring& Scoring = Context.Scoring;
+		const int32 GapStart = Scoring.GapOpen + Scoring.GapExtend;
+		const int32 Up = D1.Slot(Row - 1);
+		const int32 Left = D1.Slot(Row);
+		const int32 Diag = D2.Slot(Row - 1);
+		const int32 Target = Cur.Slot(Row);
+
+		const int32 FromHToE = D1.HScore[Up] + GapStart;
+		const int32 FromEToE = D1.EScore[Up] + Scoring.GapExtend;
+		const bool bEFromH = FromHToE > FromEToE;
+		Cur.EScore[Target] = bEFromH ? FromHToE : FromEToE;
+		Cur.EMatches[Target] = bEFromH ? D1.HMatches[Up] : D1.EMatches[Up];
+		Cur.ELength[Target] = (bEFromH ? D1.HLength[Up] : D1.ELength[Up]) + 1;
+
+		const int32 FromHToF = D1.HScore[Left] + GapStart;
+		const int32 FromFToF = D1.FScore[Left] + Scoring.GapExtend;
+		const bool bFFromH = FromHToF > FromFToF;
+		Cur.FScore[Target] = bFFromH ? FromHToF : FromFToF;
+		Cur.FMatches[Target] = bFFromH ? D1.HMatches[Left] : D1.FMatches[Left];
+		Cur.FLength[Target] = (bFFromH ? D1.HLength[Left] : D1.FLength[Left]) + 1;
+
+		int32 BestScore = D2.HScore[Diag];
+		int32 BestMatches = D2.HMatches[Diag];
+		int32 BestLength = D2.HLength[Diag];
+		if (D2.EScore[Diag] > BestScore)
+		{
+			BestScore = D2.EScore[Diag];
+			BestMatches = D2.EMatches[Diag];
+			BestLength = D2.ELength[Diag];
+		}
+		if (D2.FScore[Diag] > BestScore)
+		{
+			BestScore = D2.FScore[Diag];
+			BestMatches = D2.FMatches[Diag];
+			BestLength = D2.FLength[Diag];
+		}
+
+		const bool bMatch = Context.A[Row - 1] == Context.ReversedB[Context.LengthB - Diagonal + Row];
+		Cur.HScore[Target] = BestScore + (bMatch ? Scoring.MatchScore : Scoring.MismatchScore);
+		Cur.HMatches[Target] = BestMatches + (bMatch ? 1 : 0);
+		Cur.HLength[Target] = BestLength + 1;
+	}
+
+	static int64 CountEqualBytesScalar(const uint8* A, const uint8* B, int64 Num)
+	{
+		int64 Count = 0;
+		for (int64 Index = 0; Index < Num; ++Index)
+		{
+			Count += A[Index] == B[Index] ? 1 : 0;
+		}
+		return Count;
+	}
+
+	static FORCEINLINE float SSIMAt(const float* MuA, const float* MuB, const float* MuAA, const float* MuBB, const float* MuAB, int64 Index, float C1, float C2)
+	{
+		const float MuX = MuA[Index];
+		const float MuY = MuB[Index];
+		const float SigmaX = MuAA[Index] - MuX * MuX;
+		const float SigmaY = MuBB[Index] - MuY * MuY;
+		const float SigmaXY = MuAB[Index] - MuX * MuY;
+		return ((2.0f * MuX * MuY + C1) * (2.0f * SigmaXY + C2)) / ((MuX * MuX + MuY * MuY + C1) * (SigmaX + SigmaY + C2));
+	}
+
+	static double SumSSIMScalar(const float* MuA, const float* MuB, const float* MuAA, const float* MuBB, const float* MuAB, int64 Num, float C1, float C2)
+	{
+		double Sum = 0.0;
+		for (int64 Index = 0; Index < Num; ++Index)
+		{
+			Sum += FMath::Clamp<double>(SSIMAt(MuA, MuB, MuAA, MuBB, MuAB, Index, C1, C2), 0.0, 1.0);
+		}
+		return Sum;
+	}
+
+	static void AlignGotohDiagonals(
+		TArrayView<const uint8> A,
+		TArrayView<const uint8> B,
+		const FDeduplicationGotohScoring& Scoring,
+		TFunctionRef<bool()> ShouldStop,
+		FGotohInteriorFunction ComputeInterior,
+		FDeduplicationGotohPathStats& OutStats)
+	{
+		OutStats = FDeduplicationGotohPathStats();
+
+		const int32 LengthA = A.Num();
+		const int32 LengthB = B.Num();
+		const int32 GapStart = Scoring.GapOpen + Scoring.GapExtend;
+
+		// B is reversed so the bytes of an anti-diagonal are consecutive. Bytes are widened to the lane size inside the registers.
+		TArray<uint8> ReversedB;
+		ReversedB.SetNumUninitialized(LengthB);
+		for (int32 Index = 0; Index < LengthB; ++Index)
+		{
+			ReversedB[Index] = B[LengthB - 1 - Index];
+		}
+
+		FGotohContext Context;
+		Context.A = A.GetData();
+		Context.ReversedB = ReversedB.GetData();
+		Context.LengthA = LengthA;
+		Context.LengthB = LengthB;
+		Context.Scoring = Scoring;
+
+		const int64 BandBelow = Scoring.BandBelow;
+		const int64 BandAbove = Scoring.BandAbove;
+
+		// An anti-diagonal crosses at most (BandBelow + BandAbove) / 2 + 1 rows of the band, plus one cell on each end so the cells
+		// next to the band can always be reset.
+		const int32 MaxBandRows = static_cast<int32>(FMath::Min<int64>(LengthA + 1, (BandBelow + BandAbove) / 2 + 1));
+		FGotohDiagonal Diagonals[3];
+		for (FGotohDiagonal& Diagonal : Diagonals)
+		{
+			Diagonal.Init(MaxBandRows + 2);
+		}
+
+		const int32 LastDiagonal = LengthA + LengthB;
+		for (int32 Diagonal = 0; Diagonal <= LastDiagonal; ++Diagonal)
+		{
+			if ((Diagonal & 63) == 0 && ShouldStop())
+			{
+				return;
+			}
+
+			const FGotohDiagonal& D2 = Diagonals[(Diagonal + 1) % 3];
+			const FGotohDiagonal& D1 = Diagonals[(Diagonal + 2) % 3];
+			FGotohDiagonal& Cur = Diagonals[Diagonal % 3];
+
+			// Rows of the anti-diagonal inside the matrix and inside the band Row - BandBelow <= Column <= Row + BandAbove.
+			const int64 BandBegin = Diagonal - BandAbove > 0 ? (Diagonal - BandAbove + 1) / 2 : 0;
+			const int64 BandEnd = (Diagonal + BandBelow) / 2;
+			const int32 Begin = static_cast<int32>(FMath::Max<int64>(FMath::Max(0, Diagonal - LengthB), BandBegin));
+			const int32 End = static_cast<int32>(FMath::Min<int64>(FMath::Min(LengthA, Diagonal), BandEnd));
+			Cur.FirstRow = Begin - 1;
+
+			if (Begin == 0)
+			{
+				const int32 Target = Cur.Slot(0);
+				Cur.ResetSlot(Target);
+				if (Diagonal == 0)
+				{
+					Cur.HScore[Target] = 0;
+				}
+				else
+				{
+					// First row: F runs along the row, H takes the path of F.
+					const int32 Left = D1.Slot(0);
+					const bool bFromF = D1.FScore[Left] + Scoring.GapExtend >= D1.HScore[Left] + GapStart;
+					Cur.FScore[Target] = Scoring.GapOpen + (Diagonal - 1) * Scoring.GapExtend;
+					Cur.FMatches[Target] = Cur.HMatches[Target] = bFromF ? D1.FMatches[Left] : D1.HMatches[Left];
+					Cur.FLength[Target] = Cur.HLength[Target] = (bFromF ? D1.FLength[Left] : D1.HLength[Left]) + 1;
+				}
+			}
+
+			if (End == Diagonal && Diagonal > 0)
+			{
+				// First column: E runs down the column, H takes the path of E.
+				const int32 Up = D1.Slot(Diagonal - 1);
+				const int32 Target = Cur.Slot(Diagonal);
+				const bool bFromE = D1.EScore[Up] + Scoring.GapExtend >= D1.HScore[Up] + GapStart;
+				const int32 Matches = bFromE ? D1.EMatches[Up] : D1.HMatches[Up];
+				const int32 Length = (bFromE ? D1.ELength[Up] : D1.HLength[Up]) + 1;
+				Cur.ResetSlot(Target);
+				Cur.EScore[Target] = Scoring.GapOpen + (Diagonal - 1) * Scoring.GapExtend;
+				Cur.EMatches[Target] = Cur.HMatches[Target] = Matches;
+				Cur.ELength[Target] = Cur.HLength[Target] = Length;
+			}
+
+			const int32 InteriorBegin = FMath::Max(Begin, 1);
+			const int32 InteriorEnd = FMath::Min(End, Diagonal - 1);
+			if (InteriorBegin <= InteriorEnd)
+			{
+				ComputeInterior(Context, Diagonal, InteriorBegin, InteriorEnd, D2, D1, Cur);
+			}
+
+			// The band moves by at most one row per anti-diagonal, so the next diagonals read at most one row past either end of this one.
+			Cur.ResetCell(Begin - 1);
+			Cur.ResetCell(End + 1);
+		}
+
+		const FGotohDiagonal& Last = Diagonals[LastDiagonal % 3];
+		const int32 LastSlot = Last.Slot(LengthA);
+		int32 BestScore = Last.HScore[LastSlot];
+		OutStats.Matches = Last.HMatches[LastSlot];
+		OutStats.Length = Last.HLength[LastSlot];
+		if (Last.EScore[LastSlot] > BestScore)
+		{
+			BestScore = Last.EScore[LastSlot];
+			OutStats.Matches = Last.EMatches[LastSlot];
+			OutStats.Length = Last.ELength[LastSlot];
+		}
+		if (Last.FScore[LastSlot] > BestScore)
+		{
+			OutStats.Matches = Last.FMatches[LastSlot];
+			OutStats.Length = Last.FLength[LastSlot];
+		}
+	}
+}
+
+#if DEDUPLICATION_SIMD_X86
+namespace DeduplicationSimdKernels::Sse2
+{
+	struct FVec
+	{
+		using FRegister = __m128i;
+		static constexpr int32 Width = 4;
+
+		static FORCEINLINE FRegister Load(const int32* Source) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source)); }
+		static FORCEINLINE FRegister LoadBytes(const uint8* Source)
+		{
+			int32 Bytes;
+			FMemory::Memcpy(&Bytes, Source, sizeof(Bytes));
+			const __m128i Zero = _mm_setzero_si128();
+			return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(Bytes), Zero), Zero);
+		}
+		static FORCEINLINE void Store(int32* Target, FRegister Value) { _mm_storeu_si128(reinterpret_cast<__m128i*>(Target), Value); }
+		static FORCEINLINE FRegister Splat(int32 Value) { return _mm_set1_epi32(Value); }
+		static FORCEINLINE FRegister Add(FRegister Left, FRegister Right) { return _mm_add_epi32(Left, Right); }
+		static FORCEINLINE FRegister And(FRegister Left, FRegister Right) { return _mm_and_si128(Left, Right); }
+		static FORCEINLINE FRegister Greater(FRegister Left, FRegister Right) { return _mm_cmpgt_epi32(Left, Right); }
+		static FORCEINLINE FRegister Equal(FRegister Left, FRegister Right) { return _mm_cmpeq_epi32(Left, Right); }
+		static FORCEINLINE FRegister Select(FRegister Mask, FRegister IfTrue, FRegister IfFalse) { return _mm_or_si128(_mm_and_si128(Mask, IfTrue), _mm_andnot_si128(Mask, IfFalse)); }
+	};
+
+#include "DeduplicationGotohKernel.inl"
+
+	static int64 CountEqualBytes(const uint8* A, const uint8* B, int64 Num)
+	{
+		int64 Count = 0;
+		int64 Index = 0;
+		for (; Index + 16 <= Num; Index += 16)
+		{
+			const __m128i Equal = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(A + Index)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(B + Index)));
+			Count += FMath::CountBits(static_cast<uint64>(static_cast<uint32>(_mm_movemask_epi8(Equal))));
+		}
+		return Count + CountEqualBytesScalar(A + Index, B + Index, Num - Index);
+	}
+
+	// Min with the constant as second operand turns NaN into 1, like FMath::Clamp in the scalar kernel.
+	static double SumSSIM(const float* MuA, const float* MuB, const float* MuAA, const float* MuBB, const float* MuAB, int64 Num, float C1, float C2)
+	{
+		const __m128 VC1 = _mm_set1_ps(C1);
+		const __m128 VC2 = _mm_set1_ps(C2);
+		const __m128 Two = _mm_set1_ps(2.0f);
+		const __m128 Zero = _mm_setzero_ps();
+		const __m128 One = _mm_set1_ps(1.0f);
+		__m128d SumLow = _mm_setzero_pd();
+		__m128d SumHigh = _mm_setzero_pd();
+
+		int64 Index = 0;
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			const __m128 MuX = _mm_loadu_ps(MuA + Index);
+			const __m128 MuY = _mm_loadu_ps(MuB + Index);
+			const __m128 MuXX = _mm_mul_ps(MuX, MuX);
+			const __m128 MuYY = _mm_mul_ps(MuY, MuY);
+			const __m128 MuXY = _mm_mul_ps(MuX, MuY);
+			const __m128 SigmaX = _mm_sub_ps(_mm_loadu_ps(MuAA + Index), MuXX);
+			const __m128 SigmaY = _mm_sub_ps(_mm_loadu_ps(MuBB + Index), MuYY);
+			const __m128 SigmaXY = _mm_sub_ps(_mm_loadu_ps(MuAB + Index), MuXY);
+			const __m128 Numerator = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(Two, MuXY), VC1), _mm_add_ps(_mm_mul_ps(Two, SigmaXY), VC2));
+			const __m128 Denominator = _mm_mul_ps(_mm_add_ps(_mm_add_ps(MuXX, MuYY), VC1), _mm_add_ps(_mm_add_ps(SigmaX, SigmaY), VC2));
+			const __m128 Value = _mm_max_ps(_mm_min_ps(_mm_div_ps(Numerator, Denominator), One), Zero);
+			SumLow = _mm_add_pd(SumLow, _mm_cvtps_pd(Value));
+			SumHigh = _mm_add_pd(SumHigh, _mm_cvtps_pd(_mm_movehl_ps(Value, Value)));
+		}
+
+		double Lanes[2];
+		_mm_storeu_pd(Lanes, _mm_add_pd(SumLow, SumHigh));
+		return Lanes[0] + Lanes[1] + SumSSIMScalar(MuA + Index, MuB + Index, MuAA + Index, MuBB + Index, MuAB + Index, Num - Index, C1, C2);
+	}
+}
+
+DEDUPLICATION_AVX2_BEGIN
+namespace DeduplicationSimdKernels::Avx2
+{
+	struct FVec
+	{
+		using FRegister = __m256i;
+		static constexpr int32 Width = 8;
+
+		static FORCEINLINE FRegister Load(const int32* Source) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Source)); }
+		static FORCEINLINE FRegister LoadBytes(const uint8* Source) { return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Source))); }
+		static FORCEINLINE void Store(int32* Target, FRegister Value) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(Target), Value); }
+		static FORCEINLINE FRegister Splat(int32 Value) { return _mm256_set1_epi32(Value); }
+		static FORCEINLINE FRegister Add(FRegister Left, FRegister Right) { return _mm256_add_epi32(Left, Right); }
+		static FORCEINLINE FRegister And(FRegister Left, FRegister Right) { return _mm256_and_si256(Left, Right); }
+		static FORCEINLINE FRegister Greater(FRegister Left, FRegister Right) { return _mm256_cmpgt_epi32(Left, Right); }
+		static FORCEINLINE FRegister Equal(FRegister Left, FRegister Right) { return _mm256_cmpeq_epi32(Left, Right); }
+		static FORCEINLINE FRegister Select(FRegister Mask, FRegister IfTrue, FRegister IfFalse) { return _mm256_blendv_epi8(IfFalse, IfTrue, Mask); }
+	};
+
+#include "DeduplicationGotohKernel.inl"
+
+	static int64 CountEqualBytes(const uint8* A, const uint8* B, int64 Num)
+	{
+		int64 Count = 0;
+		int64 Index = 0;
+		for (; Index + 32 <= Num; Index += 32)
+		{
+			const __m256i Equal = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(A + Index)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(B + Index)));
+			Count += FMath::CountBits(static_cast<uint64>(static_cast<uint32>(_mm256_movemask_epi8(Equal))));
+		}
+		return Count + CountEqualBytesScalar(A + Index, B + Index, Num - Index);
+	}
+
+	// Same operations as the scalar kernel without FMA, so every lane rounds like SSIMAt.
+	static double SumSSIM(const float* MuA, const float* MuB, const float* MuAA, const float* MuBB, const float* MuAB, int64 Num, float C1, float C2)
+	{
+		const __m256 VC1 = _mm256_set1_ps(C1);
+		const __m256 VC2 = _mm256_set1_ps(C2);
+		const __m256 Two = _mm256_set1_ps(2.0f);
+		const __m256 Zero = _mm256_setzero_ps();
+		const __m256 One = _mm256_set1_ps(1.0f);
+		__m256d SumLow = _mm256_setzero_pd();
+		__m256d SumHigh = _mm256_setzero_pd();
+
+		int64 Index = 0;
+		for (; Index + 8 <= Num; Index += 8)
+		{
+			const __m256 MuX = _mm256_loadu_ps(MuA + Index);
+			const __m256 MuY = _mm256_loadu_ps(MuB + Index);
+			const __m256 MuXX = _mm256_mul_ps(MuX, MuX);
+			const __m256 MuYY = _mm256_mul_ps(MuY, MuY);
+			const __m256 MuXY = _mm256_mul_ps(MuX, MuY);
+			const __m256 SigmaX = _mm256_sub_ps(_mm256_loadu_ps(MuAA + Index), MuXX);
+			const __m256 SigmaY = _mm256_sub_ps(_mm256_loadu_ps(MuBB + Index), MuYY);
+			const __m256 SigmaXY = _mm256_sub_ps(_mm256_loadu_ps(MuAB + Index), MuXY);
+			const __m256 Numerator = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(Two, MuXY), VC1), _mm256_add_ps(_mm256_mul_ps(Two, SigmaXY), VC2));
+			const __m256 Denominator = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(MuXX, MuYY), VC1), _mm256_add_ps(_mm256_add_ps(SigmaX, SigmaY), VC2));
+			const __m256 Value = _mm256_max_ps(_mm256_min_ps(_mm256_div_ps(Numerator, Denominator), One), Zero);
+			SumLow = _mm256_add_pd(SumLow, _mm256_cvtps_pd(_mm256_castps256_ps128(Value)));
+			SumHigh = _mm256_add_pd(SumHigh, _mm256_cvtps_pd(_mm256_extractf128_ps(Value, 1)));
+		}
+
+		double Lanes[4];
+		_mm256_storeu_pd(Lanes, _mm256_add_pd(SumLow, SumHigh));
+		return Lanes[0] + Lanes[1] + Lanes[2] + Lanes[3] + SumSSIMScalar(MuA + Index, MuB + Index, MuAA + Index, MuBB + Index, MuAB + Index, Num - Index, C1, C2);
+	}
+}
+DEDUPLICATION_AVX2_END
+#endif
+
+#if DEDUPLICATION_SIMD_NEON
+namespace DeduplicationSimdKernels::Neon
+{
+	struct FVec
+	{
+		using FRegister = int32x4_t;
+		static constexpr int32 Width = 4;
+
+		static FORCEINLINE FRegister Load(const int32* Source) { return vld1q_s32(Source); }
+		static FORCEINLINE FRegister LoadBytes(const uint8* Source)
+		{
+			uint32 Bytes;
+			FMemory::Memcpy(&Bytes, Source, sizeof(Bytes));
+			return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(Bytes))))));
+		}
+		static FORCEINLINE void Store(int32* Target, FRegister Value) { vst1q_s32(Target, Value); }
+		static FORCEINLINE FRegister Splat(int32 Value) { return vdupq_n_s32(Value); }
+		static FORCEINLINE FRegister Add(FRegister Left, FRegister Right) { return vaddq_s32(Left, Right); }
+		static FORCEINLINE FRegister And(FRegister Left, FRegister Right) { return vandq_s32(Left, Right); }
+		static FORCEINLINE FRegister Greater(FRegister Left, FRegister Right) { return vreinterpretq_s32_u32(vcgtq_s32(Left, Right)); }
+		static FORCEINLINE FRegister Equal(FRegister Left, FRegister Right) { return vreinterpretq_s32_u32(vceqq_s32(Left, Right)); }
+		static FORCEINLINE FRegister Select(FRegister Mask, FRegister IfTrue, FRegister IfFalse) { return vbslq_s32(vreinterpretq_u32_s32(Mask), IfTrue, IfFalse); }
+	};
+
+#include "DeduplicationGotohKernel.inl"
+
+	static int64 CountEqualBytes(const uint8* A, const uint8* B, int64 Num)
+	{
+		int64 Count = 0;
+		int64 Index = 0;
+		for (; Index + 16 <= Num; Index += 16)
+		{
+			// Equal lanes are 0xFF, shifting leaves 1 per equal byte.
+			const uint8x16_t Equal = vshrq_n_u8(vceqq_u8(vld1q_u8(A + Index), vld1q_u8(B + Index)), 7);
+			Count += vaddlvq_u8(Equal);
+		}
+		return Count + CountEqualBytesScalar(A + Index, B + Index, Num - Index);
+	}
+
+	static double SumSSIM(const float* MuA, const float* MuB, const float* MuAA, const float* MuBB, const float* MuAB, int64 Num, float C1, float C2)
+	{
+		const float32x4_t VC1 = vdupq_n_f32(C1);
+		const float32x4_t VC2 = vdupq_n_f32(C2);
+		const float32x4_t Two = vdupq_n_f32(2.0f);
+		const float32x4_t Zero = vdupq_n_f32(0.0f);
+		const float32x4_t One = vdupq_n_f32(1.0f);
+		float64x2_t SumLow = vdupq_n_f64(0.0);
+		float64x2_t SumHigh = vdupq_n_f64(0.0);
+
+		int64 Index = 0;
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			const float32x4_t MuX = vld1q_f32(MuA + Index);
+			const float32x4_t MuY = vld1q_f32(MuB + Index);
+			const float32x4_t MuXX = vmulq_f32(MuX, MuX);
+			const float32x4_t MuYY = vmulq_f32(MuY, MuY);
+			const float32x4_t MuXY = vmulq_f32(MuX, MuY);
+			const float32x4_t SigmaX = vsubq_f32(vld1q_f32(MuAA + Index), MuXX);
+			const float32x4_t SigmaY = vsubq_f32(vld1q_f32(MuBB + Index), MuYY);
+			const float32x4_t SigmaXY = vsubq_f32(vld1q_f32(MuAB + Index), MuXY);
+			const float32x4_t Numerator = vmulq_f32(vaddq_f32(vmulq_f32(Two, MuXY), VC1), vaddq_f32(vmulq_f32(Two, SigmaXY), VC2));
+			const float32x4_t Denominator = vmulq_f32(vaddq_f32(vaddq_f32(MuXX, MuYY), VC1), vaddq_f32(vaddq_f32(SigmaX, SigmaY), VC2));
+			// The NaN-ignoring min turns NaN into 1, like FMath::Clamp in the scalar kernel.
+			const float32x4_t Value = vmaxq_f32(vminnmq_f32(vdivq_f32(Numerator, Denominator), One), Zero);
+			SumLow = vaddq_f64(SumLow, vcvt_f64_f32(vget_low_f32(Value)));
+			SumHigh = vaddq_f64(SumHigh, vcvt_high_f64_f32(Value));
+		}
+
+		return vaddvq_f64(vaddq_f64(SumLow, SumHigh)) + SumSSIMScalar(MuA + Index, MuB + Index, MuAA + Index, MuBB + Index, MuAB + Index, Num - Index, C1, C2);
+	}
+}
+#endif
+
+EDeduplicationInstructionSet FDeduplicationSimdKernels::GetInstructionSet()
+{
+	static const EDeduplicationInstructionSet InstructionSet = []()
+		{
+#if DEDUPLICATION_SIMD_X86
+			return FPlatformMisc::HasAVX2InstructionSupport() ? EDeduplicationInstructionSet::AVX2 : EDeduplicationInstructionSet::SSE2;
+#elif DEDUPLICATION_SIMD_NEON
+			return EDeduplicationInstructionSet::NEON;
+#else
+			return EDeduplicationInstructionSet::Scalar;
+#endif
+		}();
+	return InstructionSet;
+}
+
+const TCHAR* FDeduplicationSimdKernels::GetInstructionSetName(EDeduplicationInstructionSet InstructionSet)
+{
+	switch (InstructionSet)
+	{
+	case EDeduplicationInstructionSet::SSE2:
+		return TEXT("SSE2");
+	case EDeduplicationInstructionSet::AVX2:
+		return TEXT("AVX2");
+	case EDeduplicationInstructionSet::NEON:
+		return TEXT("NEON");
+	default:
+		return TEXT("Scalar");
+	}
+}
+
+bool FDeduplicationSimdKernels::AlignGotoh(
+	TArrayView<const uint8> A,
+	TArrayView<const uint8> B,
+	const FDeduplicationGotohScoring& Scoring,
+	TFunctionRef<bool()> ShouldStop,
+	FDeduplicationGotohPathStats& OutStats)
+{
+	using namespace DeduplicationSimdKernels;
+
+	FGotohInteriorFunction ComputeInterior = nullptr;
+	switch (GetInstructionSet())
+	{
+#if DEDUPLICATION_SIMD_X86
+	case EDeduplicationInstructionSet::AVX2:
+		ComputeInterior = &Avx2::ComputeGotohInterior;
+		break;
+	case EDeduplicationInstructionSet::SSE2:
+		ComputeInterior = &Sse2::ComputeGotohInterior;
+		break;
+#endif
+#if DEDUPLICATION_SIMD_NEON
+	case EDeduplicationInstructionSet::NEON:
+		ComputeInterior = &Neon::ComputeGotohInterior;
+		break;
+#endif
+	default:
+		break;
+	}
+
+	if (ComputeInterior == nullptr || A.Num() == 0 || B.Num() == 0)
+	{
+		return false;
+	}
+
+	AlignGotohDiagonals(A, B, Scoring, ShouldStop, ComputeInterior, OutStats);
+	return true;
+}
+
+int64 FDeduplicationSimdKernels::CountEqualBytes(const uint8* A, const uint8* B, int64 Num)
+{
+	using namespace DeduplicationSimdKernels;
+
+	switch (GetInstructionSet())
+	{
+#if DEDUPLICATION_SIMD_X86
+	case EDeduplicationInstructionSet::AVX2:
+		return Avx2::CountEqualBytes(A, B, Num);
+	case EDeduplicationInstructionSet::SSE2:
+		return Sse2::CountEqualBytes(A, B, Num);
+#endif
+#if DEDUPLICATION_SIMD_NEON
+	case EDeduplicationInstructionSet::NEON:
+		return Neon::CountEqualBytes(A, B, Num);
+#endif
+	default:
+		return CountEqualBytesScalar(A, B, Num);
+	}
+}
+
+double FDeduplicationSimdKernels::SumSSIM(const float* MuA, const float* MuB, const float* MuAA, const float* MuBB, const float* MuAB, int64 Num, float C1, float C2)
+{
+	using namespace DeduplicationSimdKernels;
+
+	switch (GetInstructionSet())
+	{
+#if DEDUPLICATION_SIMD_X86
+	case EDeduplicationInstructionSet::AVX2:
+		return Avx2::SumSSIM(MuA, MuB, MuAA, MuBB, MuAB, Num, C1, C2);
+	case EDeduplicationInstructionSet::SSE2:
+		return Sse2::SumSSIM(MuA, MuB, MuAA, MuBB, MuAB, Num, C1, C2);
+#endif
+#if DEDUPLICATION_SIMD_NEON
+	case EDeduplicationInstructionSet::NEON:
+		return Neon::SumSSIM(MuA, MuB, MuAA, MuBB, MuAB, Num, C1, C2);
+#endif
+	default:
+		return SumSSIMScalar(MuA, MuB, MuAA, MuBB, MuAB, Num, C1, C2);
+	}
+}
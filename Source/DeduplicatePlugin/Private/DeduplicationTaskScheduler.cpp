@@ -0,0 +1,216 @@
+/*
+ * Publisher: AO
+ * Year of Publication: 2026
+ * Copyright AO All Rights Reserved.
+ */
+
+#include "DeduplicationTaskScheduler.h"
+#include "Algo/Sort.h"
+#include "Algo/UpperBound.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Tasks/Task.h"
+#include <atomic>
+
+namespace DeduplicationTaskScheduler
+{
+	// Helper tasks currently running for all DeduplicateObjects, used to enforce the shared concurrency cap.
+	static std::atomic<int32> ActiveHelperTasks{ 0 };
+}
+
+TArray<FDeduplicationSimilarPair> FDeduplicationTaskScheduler::RunTiles(
+	int64 NumTiles,
+	int32 MaxConcurrentTasks,
+	TFunctionRef<void(int64, TArray<FDeduplicationSimilarPair>&)> ProcessTile,
+	TFunctionRef<bool()> ShouldStop,
+	TFunctionRef<void(float)> OnProgress)
+{
+	using namespace DeduplicationTaskScheduler;
+
+	TArray<FDeduplicationSimilarPair> Result;
+	if (NumTiles <= 0)
+	{
+		return Result;
+	}
+
+	std::atomic<int64> NextTile{ 0 };
+	std::atomic<int64> CompletedTiles{ 0 };
+
+	auto RunWorker = [&](TArray<FDeduplicationSimilarPair>& OutPairs, bool bReportProgress)
+		{
+			while (!ShouldStop())
+			{
+				const int64 TileIndex = NextTile.fetch_add(1);
+				if (TileIndex >= NumTiles)
+				{
+					break;
+				}
+
+				ProcessTile(TileIndex, OutPairs);
+
+				const int64 Completed = CompletedTiles.fetch_add(1) + 1;
+				if (bReportProgress)
+				{
+					OnProgress(static_cast<float>(static_cast<double>(Completed) / static_cast<double>(NumTiles)));
+				}
+			}
+		};
+
+	const int32 ConcurrencyCap = MaxConcurrentTasks > 0 ? MaxConcurrentTasks : FTaskGraphInterface::Get().GetNumWorkerThreads();
+	const int32 DesiredHelpers = static_cast<int32>(FMath::Min<int64>(NumTiles - 1, ConcurrencyCap));
+
+	TArray<TArray<FDeduplicationSimilarPair>> WorkerPairs;
+	WorkerPairs.SetNum(DesiredHelpers + 1);
+
+	TArray<UE::Tasks::FTask> HelperTasks;
+	HelperTasks.Reserve(DesiredHelpers);
+	for (int32 HelperIndex = 0; HelperIndex < DesiredHelpers; ++HelperIndex)
+	{
+		if (ActiveHelperTasks.fetch_add(1) >= ConcurrencyCap)
+		{
+			ActiveHelperTasks.fetch_sub(1);
+			break;
+		}
+
+		TArray<FDeduplicationSimilarPair>& HelperPairs = WorkerPairs[HelperIndex + 1];
+		HelperTasks.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [&RunWorker, &HelperPairs]()
+			{
+				RunWorker(HelperPairs, false);
+				ActiveHelperTasks.fetch_sub(1);
+			}));
+	}
+
+	// The calling thread always takes part, so the work progresses even when the cap is exhausted by other DeduplicateObjects.
+	RunWorker(WorkerPairs[0], true);
+	UE::Tasks::Wait(HelperTasks);
+
+	int32 NumPairs = 0;
+	for (const TArray<FDeduplicationSimilarPair>& Pairs : WorkerPairs)
+	{
+		NumPairs += Pairs.Num();
+	}
+
+	Result.Reserve(NumPairs);
+	for (TArray<FDeduplicationSimilarPair>& Pairs : WorkerPairs)
+	{
+		Result.Append(MoveTemp(Pairs));
+	}
+
+	Algo::Sort(Result, [](const FDeduplicationSimilarPair& Left, const FDeduplicationSimilarPair& Right)
+		{
+			return Left.IndexA != Right.IndexA ? Left.IndexA < Right.IndexA : Left.IndexB < Right.IndexB;
+		});
+
+	return Result;
+}
+
+TArray<FDeduplicationSimilarPair> FDeduplicationTaskScheduler::FindSimilarPairs(
+	int32 NumItems,
+	float Threshold,
+	int32 TileSize,
+	int32 MaxConcurrentTasks,
+	TFunctionRef<float(int32, int32)> Similarity,
+	TFunctionRef<bool()> ShouldStop,
+	TFunctionRef<void(float)> OnProgress)
+{
+	if (NumItems < 2)
+	{
+		return TArray<FDeduplicationSimilarPair>();
+	}
+
+	TileSize = FMath::Max(1, TileSize);
+	const int32 NumBlocks = FMath::DivideAndRoundUp(NumItems, TileSize);
+
+	// Tiles of the upper triangle are numbered row by row, RowStarts[Row] is the number of the first tile of the block row.
+	TArray<int64> RowStarts;
+	RowStarts.SetNumUninitialized(NumBlocks);
+	int64 NumTiles = 0;
+	for (int32 BlockRow = 0; BlockRow < NumBlocks; ++BlockRow)
+	{
+		RowStarts[BlockRow] = NumTiles;
+		NumTiles += NumBlocks - BlockRow;
+	}
+
+	return RunTiles(NumTiles, MaxConcurrentTasks, [&](int64 TileIndex, TArray<FDeduplicationSimilarPair>& OutPairs)
+		{
+			const int32 BlockRow = Algo::UpperBound(RowStarts, TileIndex) - 1;
+			const int32 BlockColumn = BlockRow + static_cast<int32>(TileIndex - RowStarts[BlockRow]);
+
+			const int32 BeginA = BlockRow * TileSize;
+			const int32 EndA = FMath::Min(BeginA + TileSize, NumItems);
+			const int32 BeginB = BlockColumn * TileSize;
+			const int32 EndB = FMath::Min(BeginB + TileSize, NumItems);
+
+			for (int32 IndexA = BeginA; IndexA < EndA; ++IndexA)
+			{
+				if (ShouldStop())
+				{
+					break;
+				}
+
+				for (int32 IndexB = FMath::Max(BeginB, IndexA + 1); IndexB < EndB; ++IndexB)
+				{
+					const float PairSimilarity = Similarity(IndexA, IndexB);
+					if (PairSimilarity >= Threshold)
+					{
+						OutPairs.Add({ IndexA, IndexB, PairSimilarity });
+					}
+				}
+			}
+		}, ShouldStop, OnProgress);
+}
+
+TArray<FDeduplicationSimilarPair> FDeduplicationTaskScheduler::FilterSimilarPairs(
+	TArrayView<const TPair<int32, int32>> CandidatePairs,
+	float Threshold,
+	int32 TileSize,
+	int32 MaxConcurrentTasks,
+	TFunctionRef<float(int32, int32)> Similarity,
+	TFunctionRef<bool()> ShouldStop,
+	TFunctionRef<void(float)> OnProgress)
+{
+	// A tile holds as many candidates as a full TileSize x TileSize tile of the comparison matrix holds pairs.
+	const int64 PairsPerTile = FMath::Max<int64>(1, static_cast<int64>(TileSize) * TileSize);
+	const int64 NumTiles = (CandidatePairs.Num() + PairsPerTile - 1) / PairsPerTile;
+
+	return RunTiles(NumTiles, MaxConcurrentTasks, [&](int64 TileIndex, TArray<FDeduplicationSimilarPair>& OutPairs)
+		{
+			const int64 Begin = TileIndex * PairsPerTile;
+			const int64 End = FMath::Min<int64>(Begin + PairsPerTile, CandidatePairs.Num());
+			for (int64 CandidateIndex = Begin; CandidateIndex < End; ++CandidateIndex)
+			{
+				if ((CandidateIndex & 63) == 0 && ShouldStop())
+				{
+					break;
+				}
+
+				const int32 IndexA = FMath::Min(CandidatePairs[CandidateIndex].Key, CandidatePairs[CandidateIndex].Value);
+				const int32 IndexB = FMath::Max(CandidatePairs[CandidateIndex].Key, CandidatePairs[CandidateIndex].Value);
+				const float PairSimilarity = Similarity(IndexA, IndexB);
+				if (PairSimilarity >= Threshold)
+				{
+					OutPairs.Add({ IndexA, IndexB, PairSimilarity });
+				}
+			}
+		}, ShouldStop, OnProgress);
+}
+
+void FDeduplicationTaskScheduler::ParallelFor(
+	int32 NumItems,
+	int32 ChunkSize,
+	int32 MaxConcurrentTasks,
+	TFunctionRef<void(int32)> Body,
+	TFunctionRef<bool()> ShouldStop)
+{
+	ChunkSize = FMath::Max(1, ChunkSize);
+	const int64 NumTiles = FMath::DivideAndRoundUp(NumItems, ChunkSize);
+
+	RunTiles(NumTiles, MaxConcurrentTasks, [&](int64 TileIndex, TArray<FDeduplicationSimilarPair>& OutPairs)
+		{
+			const int32 Begin = static_cast<int32>(TileIndex) * ChunkSize;
+			const int32 End = FMath::Min(Begin + ChunkSize, NumItems);
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				Body(Index);
+			}
+		}, ShouldStop, [](float) {});
+}
@@ -10,6 +10,7 @@
 #include "UObject/Object.h"
 #include "Engine/AssetManager.h"
 #include "AssetRegistry/AssetRegistryModule.h"
+#include "DeduplicationTaskScheduler.h"
 #include "DeduplicateObject.generated.h"
 
 class UDeduplicationManager;
@@ -29,6 +30,15 @@ struct DEDUPLICATEPLUGIN_API FDuplicateGroup
 	UPROPERTY(BlueprintReadWrite, VisibleAnywhere, Category = "Deduplication")
 	FName AlghoritmName;
 
+	//IDs in the manager asset table. Only set on the copies the manager stores internally, where they replace DuplicateAssets to keep groups compact.
+	//Groups broadcast by DeduplicateObjects always carry DuplicateAssets.
+	TArray<int32> AssetIds;
+
+	int32 NumAssets() const
+	{
+		return DuplicateAssets.Num() > 0 ? DuplicateAssets.Num() : AssetIds.Num();
+	}
+
 	FDuplicateGroup()
 	{
 		DuplicateAssets.Empty();
@@ -43,7 +53,7 @@ struct DEDUPLICATEPLUGIN_API FDuplicateGroup
 
 	bool operator==(const FDuplicateGroup& Other) const
 	{
-		if (DuplicateAssets.Num() != Other.DuplicateAssets.Num())
+		if (DuplicateAssets.Num() != Other.DuplicateAssets.Num() || AssetIds != Other.AssetIds)
 		{
 			return false;
 		}
@@ -87,6 +97,10 @@ public:
 
 	virtual void FindDuplicates(const TArray<FAssetData>& AssetsToAnalyzee);
 
+	//Batched execution. Every asset group is processed by this instance as an independent sub-job, one after another,
+	//and OnDeduplicationCompleted is broadcast once with the groups found in all of them. Used for the groups produced by early checks.
+	virtual void FindDuplicatesInGroups(const TArray<TArray<FAssetData>>& AssetGroups);
+
 	virtual void Iternal_StartFindDeduplicatesAfterLoad();
 
 	//The main function to be rewritten for Deduplication implementation.
@@ -123,6 +137,14 @@ public:
 	bool ShouldLoadAssets();
 	virtual bool ShouldLoadAssets_Implementation();
 
+	//Reuse per-asset features stored in the persistent fingerprint cache (Saved/DeduplicationCache) from previous runs.
+	//Assets whose package did not change since then are not loaded or serialized again.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Deduplication")
+	bool bUseFingerprintCache = true;
+
+	//Returns true if everything this algorithm needs for the asset is already in the fingerprint cache, so the asset does not have to be preloaded.
+	virtual bool IsAssetFeatureCached(const FAssetData& Asset) const;
+
 	FOnDeduplicationProgressCompleted OnDeduplicationProgressCompleted;
 
 	FOnDeduplicationCompleted OnDeduplicationCompleted;
@@ -153,5 +175,24 @@ protected:
 	UFUNCTION(BlueprintCallable, Category = "Deduplication")
 	void SetProgress(float NewProgress);
 
+	//Evaluates Similarity for every pair of NumItems items in parallel tiles and returns the pairs that reached SimilarityThreshold, sorted by index.
+	//Progress is reported as the completed fraction multiplied by ProgressScale.
+	TArray<FDeduplicationSimilarPair> FindSimilarPairs(int32 NumItems, TFunctionRef<float(int32, int32)> Similarity, float ProgressScale = 1.0f);
+
+	//Same as FindSimilarPairs, but only evaluates the given candidate pairs.
+	TArray<FDeduplicationSimilarPair> FilterSimilarPairs(TArrayView<const TPair<int32, int32>> CandidatePairs, TFunctionRef<float(int32, int32)> Similarity, float ProgressScale = 1.0f);
+
+	//Runs Body for every item index on the same workers as the pairwise comparisons.
+	void ParallelForItems(int32 NumItems, TFunctionRef<void(int32)> Body) const;
+
 	bool ShouldStop() const;
+
+private:
+	//Sub-jobs of the batched execution and their complexities. Empty when the instance runs a single asset list.
+	TArray<TArray<FAssetData>> BatchAssetGroups;
+	TArray<float> BatchComplexities;
+	bool bBatchExecution = false;
+
+	//Progress of the finished sub-jobs, added to the progress reported by the running one.
+	float BatchProgressOffset = 0.0f;
 };
@@ -8,6 +8,8 @@
 
 #include "CoreMinimal.h"
 #include "DeduplicateObjects/DeduplicateObject.h"
+#include "IO/IoHash.h"
+#include "DeduplicationAssetByteStore.h"
 #include "EqualDataBaseDeduplication.generated.h"
 
 /**
@@ -26,13 +28,133 @@ public:
 
 	virtual float CalculateComplexity_Implementation(const TArray<FAssetData>& CheckAssets) override;
 
+	virtual bool IsAssetFeatureCached(const FAssetData& Asset) const override;
+
 protected:
+	struct FAssetDataDigest
+	{
+		FIoHash Hash;
+		int64 Size = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FAssetDataDigest& Digest)
+		{
+			Ar << Digest.Hash;
+			Ar << Digest.Size;
+			return Ar;
+		}
+	};
+
+	//Byte histogram and hashed 4-gram counts of the raw data, used to bound the similarity of a pair before the full comparison.
+	struct FAssetDataSketch
+	{
+		TArray<uint32> ByteHistogram;
+		TArray<uint32> QGramCounts;
+
+		friend FArchive& operator<<(FArchive& Ar, FAssetDataSketch& Sketch)
+		{
+			Ar << Sketch.ByteHistogram;
+			Ar << Sketch.QGramCounts;
+			return Ar;
+		}
+	};
+
+	//Everything the algorithm knows about an asset without holding its bytes: a digest of the raw data and optional compact features.
+	struct FAssetDataSample
+	{
+		FAssetDataDigest Digest;
+		TArray<uint8> Features;
+		FAssetDataSketch Sketch;
+		bool bHasFeatures = false;
+		bool bHasSketch = false;
+		bool bValid = false;
+	};
+
+	//Cheapest bound that proved a pair can not reach SimilarityThreshold.
+	enum class EPrefilterTier : uint8
+	{
+		Passed,
+		Length,
+		ByteHistogram,
+		QGram,
+		Num
+	};
+
 	virtual float CalculateConfidenceScore_Implementation(const TArray<FAssetData>& Assets) const override;
-	virtual float CalculateSimilarity(const TArray<uint8>& Data1, const TArray<uint8>& Data2) const;
+	virtual float CalculateSimilarity(TArrayView<const uint8> Data1, TArrayView<const uint8> Data2) const;
 	bool LoadAssetData(const FAssetData& Asset, TArray<uint8>& OutData) const;
-	virtual float CalculateBinarySimilarity(const TArray<uint8>& Data1, const TArray<uint8>& Data2) const;
+	bool GetAssetPackageFilename(const FAssetData& Asset, FString& OutFilename) const;
+
+	//Loads the asset bytes without going through the byte store. Package files are memory mapped when bUseMemoryMappedReads is set.
+	FDeduplicationAssetBytes LoadAssetBytes(const FAssetData& Asset) const;
+
+	virtual float CalculateBinarySimilarity(TArrayView<const uint8> Data1, TArrayView<const uint8> Data2) const;
 	virtual bool ShouldLoadAssets_Implementation();
 
+	//Name of the compact per-asset features of the algorithm. NAME_None means the algorithm always compares raw bytes.
+	//Must change whenever a setting that affects BuildAssetFeatures changes.
+	virtual FName GetAssetFeatureName() const;
+
+	//Builds compact features from raw asset bytes. They are stored in the fingerprint cache and compared by CalculateFeatureSimilarity.
+	virtual bool BuildAssetFeatures(TArrayView<const uint8> Data, TArray<uint8>& OutFeatures) const;
+	virtual float CalculateFeatureSimilarity(const TArray<uint8>& Features1, const TArray<uint8>& Features2) const;
+
+	//Optional candidate generation. When it returns true only OutCandidatePairs (indices into Samples) are compared, otherwise every pair is.
+	//Samples may contain nulls for assets that could not be resolved.
+	virtual bool GenerateCandidatePairs(TArrayView<const FAssetDataSample* const> Samples, TArray<TPair<int32, int32>>& OutCandidatePairs) const;
+
+	//True if CalculateBinarySimilarity is the number of matching bytes divided by the length of a global alignment of the two buffers.
+	//Such a similarity is bounded by the length ratio, the byte histograms and the shared q-grams, so the prefilter can reject pairs safely.
+	virtual bool SupportsAlignmentPrefilter() const;
+
+	//Returns the first prefilter tier whose upper bound of the similarity is below SimilarityThreshold, or Passed.
+	EPrefilterTier GetPrefilterRejectTier(const FAssetDataSample& Sample1, const FAssetDataSample& Sample2) const;
+
+	//Returns the asset bytes through the per-run byte store, so each asset is loaded or serialized only once per run.
+	FDeduplicationAssetBytes GetAssetBytes(const FAssetData& Asset) const;
+
+	bool ResolveAssetSample(const FAssetData& Asset, FAssetDataSample& OutSample) const;
+	bool TryCalculateAssetSimilarity(const FAssetData& Asset1, const FAssetDataSample& Sample1, const FAssetData& Asset2, const FAssetDataSample& Sample2, float& OutSimilarity) const;
+
+	//Identifies which bytes are compared (serialized object, whole package, package exports), part of every cached feature name.
+	const TCHAR* GetByteSourceName() const;
+	FName GetCachedDigestName() const;
+	FName GetCachedFeatureName() const;
+	FName GetCachedSketchName() const;
+	bool ShouldBuildSketches() const;
+
+	//Samples resolved for the current run, keyed by asset path.
+	TMap<FSoftObjectPath, FAssetDataSample> AssetSamples;
+
+	//Raw bytes of the current run. Only valid while Internal_FindDuplicates is running.
+	TSharedPtr<FDeduplicationAssetByteStore, ESPMode::ThreadSafe> AssetByteStore;
+
+	//Keeps UObject::Serialize from running on two threads at once when a worker has to serialize an asset again.
+	mutable FCriticalSection SerializationLock;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Deduplication")
 	bool ShouldUseSerialization = true;
+
+	//Map package files into memory instead of copying them to the heap when ShouldUseSerialization is off.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Deduplication")
+	bool bUseMemoryMappedReads = true;
+
+	//Compare only the serialized exports and bulk data of package files, without the summary, name map, import and export tables that contain the asset path.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Deduplication", meta = (EditCondition = "!ShouldUseSerialization"))
+	bool bCompareExportsOnly = true;
+
+	//Replace the name map indices in the tagged property headers of the exports with indices into the sorted name map, so equal names compare equal across packages.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Deduplication", meta = (EditCondition = "!ShouldUseSerialization && bCompareExportsOnly"))
+	bool bNormalizeNameIndices = false;
+
+	//Reject pairs with cheap similarity bounds (length ratio, byte histogram, q-grams) before the full comparison. Only used by alignment based algorithms.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Deduplication")
+	bool bUseSimilarityPrefilter = true;
+
+	//How many megabytes of raw asset bytes are kept in memory during a run. Least recently used buffers above the budget are spilled to disk.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Deduplication", meta = (ClampMin = "0"))
+	int32 AssetBytesMemoryBudgetMB = 1024;
+
+	//How many memory mapped files are kept open during a run. Each one holds a file handle, least recently used ones above the count are closed.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Deduplication", meta = (ClampMin = "1"))
+	int32 MaxLiveMappedFiles = 256;
 };
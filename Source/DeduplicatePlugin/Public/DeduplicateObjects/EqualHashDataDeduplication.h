@@ -10,6 +10,15 @@
 #include "DeduplicateObjects/EqualDataBaseDeduplication.h"
 #include "EqualHashDataDeduplication.generated.h"
 
+//Resolved chunking parameters, AverageSize is a power of two.
+struct FEqualHashChunkingSettings
+{
+	bool bContentDefined = true;
+	int32 MinSize = 32;
+	int32 AverageSize = 128;
+	int32 MaxSize = 1024;
+};
+
 /**
  * 
  */
@@ -19,5 +28,51 @@ class DEDUPLICATEPLUGIN_API UEqualHashDataDeduplication : public UEqualBaseDataD
 	GENERATED_BODY()
 
 public:
-	virtual float CalculateBinarySimilarity(const TArray<uint8>& Data1, const TArray<uint8>& Data2) const override;
+	virtual float CalculateBinarySimilarity(TArrayView<const uint8> Data1, TArrayView<const uint8> Data2) const override;
+
+protected:
+	//Features are the sorted unique 64-bit chunk hashes of the data, so cached assets are compared without loading them.
+	virtual FName GetAssetFeatureName() const override;
+	virtual bool BuildAssetFeatures(TArrayView<const uint8> Data, TArray<uint8>& OutFeatures) const override;
+	virtual float CalculateFeatureSimilarity(const TArray<uint8>& Features1, const TArray<uint8>& Features2) const override;
+
+	//Split the data at content-defined cut points found by a Gear rolling hash, so inserted or removed bytes only change the chunks around them.
+	//When disabled the data is split into fixed 64 byte blocks.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hash Data Deduplication")
+	bool bUseContentDefinedChunking = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hash Data Deduplication", meta = (EditCondition = "bUseContentDefinedChunking", ClampMin = "1"))
+	int32 MinChunkSize = 32;
+
+	//Rounded up to a power of two.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hash Data Deduplication", meta = (EditCondition = "bUseContentDefinedChunking", ClampMin = "4"))
+	int32 AverageChunkSize = 128;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hash Data Deduplication", meta = (EditCondition = "bUseContentDefinedChunking", ClampMin = "8"))
+	int32 MaxChunkSize = 1024;
+
+	FEqualHashChunkingSettings GetChunkingSettings() const;
+
+	//Builds a MinHash signature of every chunk hash set and returns only the pairs that share at least one LSH band bucket.
+	virtual bool GenerateCandidatePairs(TArrayView<const FAssetDataSample* const> Samples, TArray<TPair<int32, int32>>& OutCandidatePairs) const override;
+
+	//Compare only pairs whose MinHash signatures collide in at least one band instead of all pairs.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hash Data Deduplication")
+	bool bUseMinHashCandidates = true;
+
+	//Pick bands and rows from SimilarityThreshold so that a pair exactly at the threshold becomes a candidate with at least 99% probability.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hash Data Deduplication", meta = (EditCondition = "bUseMinHashCandidates"))
+	bool bAutoTuneMinHashBands = true;
+
+	//Number of MinHash values per asset when the bands are tuned automatically.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hash Data Deduplication", meta = (EditCondition = "bUseMinHashCandidates && bAutoTuneMinHashBands", ClampMin = "1", ClampMax = "1024"))
+	int32 MinHashSignatureSize = 128;
+
+	//More bands find less similar pairs at the cost of more candidates.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hash Data Deduplication", meta = (EditCondition = "bUseMinHashCandidates && !bAutoTuneMinHashBands", ClampMin = "1"))
+	int32 MinHashBands = 32;
+
+	//More rows per band make a collision require a higher similarity.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hash Data Deduplication", meta = (EditCondition = "bUseMinHashCandidates && !bAutoTuneMinHashBands", ClampMin = "1"))
+	int32 MinHashRowsPerBand = 4;
 };
\ No newline at end of file
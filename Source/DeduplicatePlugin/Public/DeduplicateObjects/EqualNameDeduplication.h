@@ -10,6 +10,26 @@
 #include "DeduplicateObject.h"
 #include "EqualNameDeduplication.generated.h"
 
+//Trie over CommonPrefixesToIgnore, so a name is matched against all prefixes in one walk over its first characters.
+struct FAssetNamePrefixTrie
+{
+	void Build(const TArray<FString>& Prefixes, bool bInIgnoreCase);
+
+	//Length of the earliest prefix in the list that Name starts with, or INDEX_NONE if none does.
+	int32 FindPrefixLength(FStringView Name) const;
+
+private:
+	struct FNode
+	{
+		TArray<TPair<TCHAR, int32>, TInlineAllocator<4>> Children;
+		int32 PrefixIndex = INDEX_NONE;
+		int32 PrefixLength = 0;
+	};
+
+	TArray<FNode> Nodes;
+	bool bIgnoreCase = false;
+};
+
 /**
  * Deduplication algorithm that compares asset names
  * Groups assets with identical names as potential duplicates
@@ -31,7 +51,13 @@ protected:
 
 private:
 	bool AreNamesEqual(const FString& Name1, const FString& Name2) const;
-	FString NormalizeAssetName(const FString& AssetName) const;
+	FString NormalizeAssetName(const FString& AssetName, const FAssetNamePrefixTrie& PrefixTrie) const;
+
+	// Normalizes the name of every asset once, grouping and confidence scoring then only read NormalizedNames.
+	void BuildNormalizedNames(const TArray<FAssetData>& Assets);
+
+	// Upper bound of the edit distance that can still pass SimilarityThreshold, so distances above it are not computed in full.
+	int32 GetMaxAcceptedDistance() const;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Name Deduplication", meta = (AllowPrivateAccess = "true"))
 	bool bIgnoreCase = true;
@@ -55,4 +81,7 @@ private:
 	// If False � the penalty is calculated based on the absolute number of differing characters.
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Name Deduplication", meta = (AllowPrivateAccess = "true"))
 	bool bBlendPenaltyBySize = false;
+
+	// Normalized names of the assets of the current run, keyed by object path.
+	TMap<FSoftObjectPath, FString> NormalizedNames;
 };
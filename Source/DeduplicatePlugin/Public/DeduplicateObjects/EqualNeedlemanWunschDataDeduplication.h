@@ -24,7 +24,12 @@ class DEDUPLICATEPLUGIN_API UEqualNeedlemanWunschDataDeduplication : public UEqu
 public:
 	UEqualNeedlemanWunschDataDeduplication();
 
-	float CalculateBinarySimilarity(const TArray<uint8>& Data1, const TArray<uint8>& Data2) const;
+	virtual float CalculateBinarySimilarity(TArrayView<const uint8> Data1, TArrayView<const uint8> Data2) const override;
+
+protected:
+	virtual bool SupportsAlignmentPrefilter() const override;
+
+public:
 
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Needleman Wunsch Data Deduplication")
 	int32 MatchScore = 2;
@@ -37,4 +42,19 @@ public:
 
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Needleman Wunsch Data Deduplication")
 	int32 GapExtend = -1;
+
+	//Evaluate anti-diagonals in SSE2/AVX2/NEON lanes when the CPU supports it. The result is the same as the scalar kernel.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Needleman Wunsch Data Deduplication")
+	bool bUseVectorizedKernel = true;
+
+	//Only evaluate cells near the diagonal. Much faster for large assets, but alignments leaving the band are not found.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Needleman Wunsch Data Deduplication")
+	bool bUseDiagonalBand = false;
+
+	//Band slack on each side of the diagonal as a fraction of the longer data, added to the size difference of the two assets.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Needleman Wunsch Data Deduplication", meta = (EditCondition = "bUseDiagonalBand", ClampMin = "0.0", ClampMax = "1.0"))
+	float BandWidthRatio = 0.05f;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Needleman Wunsch Data Deduplication", meta = (EditCondition = "bUseDiagonalBand", ClampMin = "1"))
+	int32 MinBandWidth = 256;
 };
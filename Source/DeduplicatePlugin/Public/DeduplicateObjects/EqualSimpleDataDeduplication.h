@@ -21,7 +21,12 @@ class DEDUPLICATEPLUGIN_API UEqualSimpleUassetDataDeduplication : public UEqualB
 public:
 	UEqualSimpleUassetDataDeduplication();
 
-	virtual float CalculateBinarySimilarity(const TArray<uint8>& Data1, const TArray<uint8>& Data2) const override;
+	virtual float CalculateBinarySimilarity(TArrayView<const uint8> Data1, TArrayView<const uint8> Data2) const override;
+
+	//Instead of comparing bytes at equal offsets, score the share of MinCommonSubstringLength-grams that occur anywhere in the other asset.
+	//Tolerates inserted and moved data.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Content Deduplication")
+	bool bUseCommonSubstringSimilarity = false;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Content Deduplication", meta = (AllowPrivateAccess = "true"))
 	int32 MinCommonSubstringLength = 4;
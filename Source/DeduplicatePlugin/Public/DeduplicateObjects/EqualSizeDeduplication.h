@@ -30,6 +30,22 @@ protected:
 
 	int64 GetAssetFileSize(const FAssetData& Asset) const;
 
+	// Measures all assets at once. With UseLoadingSize the resource sizes are gathered on the game thread in time-sliced ticks,
+	// the calling thread waits once for the whole batch instead of once per asset.
+	void CollectAssetSizes(const TArray<FAssetData>& Assets, TArray<int64>& OutSizes) const;
+
+	// Size of the .uasset file of the asset, or -1.
+	static int64 GetPackageFileSize(const FAssetData& Asset);
+
+	// Whether UseLoadingSize measures the asset by its resource size rather than its file.
+	static bool UsesResourceSize(const FAssetData& Asset);
+
+	// Penalty for the size difference of two assets, absolute or relative depending on bBlendPenaltyBySize. Grows with the difference.
+	float GetSizePenalty(int64 SizeA, int64 SizeB) const;
+
+	// Size of an asset of the current run, or GetAssetFileSize for assets outside it.
+	int64 GetCachedAssetSize(const FAssetData& Asset) const;
+
 	// Penalty applied for the difference between two sizes. It can be based on the number of mismatched size bytes
 	// or the relative difference between names, depending on bBlendPenaltyBySize.
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Size Deduplication")
@@ -49,4 +65,11 @@ protected:
 	*/
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Size Deduplication")
 	bool UseLoadingSize = false;
+
+	// Game thread time spent per tick on gathering resource sizes when UseLoadingSize is set.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Size Deduplication", meta = (ClampMin = "0.5", EditCondition = "UseLoadingSize"))
+	float ResourceSizeTimeSliceMs = 5.0f;
+
+	// Sizes of the assets of the current run, keyed by object path, so every asset is measured once.
+	TMap<FSoftObjectPath, int64> AssetSizes;
 };
@@ -31,6 +31,15 @@ struct FGraphNodeSignature
 	TMap<FString, FString> PropertyValues;
 
 	bool operator==(const FGraphNodeSignature& Other) const;
+
+	friend FArchive& operator<<(FArchive& Ar, FGraphNodeSignature& Signature)
+	{
+		Ar << Signature.NodeClassName;
+		Ar << Signature.InputPinNames;
+		Ar << Signature.OutputPinNames;
+		Ar << Signature.PropertyValues;
+		return Ar;
+	}
 };
 
 USTRUCT()
@@ -45,6 +54,13 @@ struct FGraphSignature
 	int32 TotalNodeCount = 0;
 
 	bool operator==(const FGraphSignature& Other) const;
+
+	friend FArchive& operator<<(FArchive& Ar, FGraphSignature& Signature)
+	{
+		Ar << Signature.NodeSignatures;
+		Ar << Signature.TotalNodeCount;
+		return Ar;
+	}
 };
 
 /**
@@ -67,12 +83,19 @@ public:
 
 	virtual FString GetAlgorithmName_Implementation() const override;
 
+	virtual bool IsAssetFeatureCached(const FAssetData& Asset) const override;
+
 protected:
 	virtual float CalculateConfidenceScore_Implementation(const TArray<FAssetData>& Assets) const override;
 
 	virtual float CalculateComplexity_Implementation(const TArray<FAssetData>& CheckAssets) override;
 
 private:
+	//Returns graph signatures of the asset from the fingerprint cache, or loads the asset and extracts them.
+	bool GetAssetGraphSignatures(const FAssetData& AssetData, TArray<FGraphSignature>& OutSignatures) const;
+
+	FName GetCachedSignaturesName() const;
+
 	TArray<FGraphSignature> ExtractGraphSignatures(UObject* Object) const;
 
 	TArray<UEdGraph*> GetAllGraphsFromObject(UObject* Object) const;
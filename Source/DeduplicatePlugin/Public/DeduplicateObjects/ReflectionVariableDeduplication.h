@@ -10,6 +10,53 @@
 #include "DeduplicateObject.h"
 #include "ReflectionVariableDeduplication.generated.h"
 
+USTRUCT()
+struct FReflectionPropertyFingerprint
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FName PropertyName;
+
+	UPROPERTY()
+	FString Signature;
+
+	UPROPERTY()
+	FString Value;
+
+	friend FArchive& operator<<(FArchive& Ar, FReflectionPropertyFingerprint& Fingerprint)
+	{
+		Ar << Fingerprint.PropertyName;
+		Ar << Fingerprint.Signature;
+		Ar << Fingerprint.Value;
+		return Ar;
+	}
+};
+
+//Everything CompareReflectionFingerprints needs from an object: its native parent class and the filtered default property values.
+USTRUCT()
+struct FReflectionFingerprint
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString CppParentClassPath;
+
+	UPROPERTY()
+	TArray<FReflectionPropertyFingerprint> Properties;
+
+	UPROPERTY()
+	bool bValid = false;
+
+	friend FArchive& operator<<(FArchive& Ar, FReflectionFingerprint& Fingerprint)
+	{
+		Ar << Fingerprint.CppParentClassPath;
+		Ar << Fingerprint.Properties;
+		Ar << Fingerprint.bValid;
+		return Ar;
+	}
+};
+
 /**
  * Deduplication algorithm that analyzes equivalence of all variables in objects and their default values,
  * accessible through reflection. Compares properties marked with UPROPERTY and their default values.
@@ -28,17 +75,26 @@ public:
 
 	virtual FString GetAlgorithmName_Implementation() const override;
 
+	virtual bool IsAssetFeatureCached(const FAssetData& Asset) const override;
+
 protected:
 	virtual float CalculateConfidenceScore_Implementation(const TArray<FAssetData>& Assets) const override;
 
 	virtual float CalculateComplexity_Implementation(const TArray<FAssetData>& CheckAssets) override;
 
 private:
-	float CompareObjectsByReflection(UObject* ObjectA, UObject* ObjectB) const;
+	//Returns the reflection fingerprint of the asset from the fingerprint cache, or loads the asset and builds it.
+	bool GetAssetReflectionFingerprint(const FAssetData& AssetData, FReflectionFingerprint& OutFingerprint) const;
 
-	FString GetPropertySignature(const FProperty* Property) const;
+	FName GetCachedFingerprintName() const;
+
+	FReflectionFingerprint BuildReflectionFingerprint(UObject* Object) const;
+
+	bool ShouldCompareProperty(const FProperty* Property) const;
 
-	bool ArePropertyValuesEqual(const FProperty* Property, const void* ValueA, const void* ValueB) const;
+	float CompareReflectionFingerprints(const FReflectionFingerprint& FingerprintA, const FReflectionFingerprint& FingerprintB) const;
+
+	FString GetPropertySignature(const FProperty* Property) const;
 
 	UClass* GetRealClass(UObject* Object) const;
 
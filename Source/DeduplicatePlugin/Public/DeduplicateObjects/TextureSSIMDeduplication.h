@@ -13,6 +13,11 @@
 #include "UObject/NoExportTypes.h"
 #include "TextureSSIMDeduplication.generated.h"
 
+namespace TextureSSIMDeduplication
+{
+    struct FSSIMScratch;
+}
+
 /**
  * 
  */
@@ -30,6 +35,7 @@ public:
     virtual float CalculateComplexity_Implementation(const TArray<FAssetData>& CheckAssets) override;
     virtual bool ShouldLoadAssets_Implementation() override;
     virtual FString GetAlgorithmName_Implementation() const override { return GetClass()->GetName(); }
+    virtual bool IsAssetFeatureCached(const FAssetData& Asset) const override;
 
 protected:
     struct FLoadedTexture
@@ -38,14 +44,54 @@ protected:
         TArray<float> Gray; // luminance [0..1]
         int32 Width = 0;
         int32 Height = 0;
+        // Resolution of the texture before it was reduced to the working resolution
+        int32 SourceWidth = 0;
+        int32 SourceHeight = 0;
         bool bValid = false;
     };
 
+    // Luminance of one texture at every MS-SSIM scale, decoded once per run and shared by grouping and confidence scoring
+    struct FLuminancePyramid
+    {
+        int32 SourceWidth = 0;
+        int32 SourceHeight = 0;
+        // Level 0 is the working resolution, every further level is half the size of the previous one.
+        // Stored with 16-bit precision like the cached luminance and widened to float for each comparison
+        TArray<TArray<uint16>> Levels;
+        TArray<FIntPoint> LevelSizes;
+        // 64-bit DCT hash of the luminance, independent of the resolution
+        uint64 PerceptualHash = 0;
+        // Almost no energy outside DC, so the hash bits only reflect noise and the hash cannot prefilter the texture
+        bool bFlat = false;
+    };
+
+    using FLuminancePyramidPtr = TSharedPtr<const FLuminancePyramid, ESPMode::ThreadSafe>;
+
     bool LoadTextureGrayFromAsset(const FAssetData& Asset, FLoadedTexture& OutTexture);
+    // Decodes the luminance from the texture source on the calling thread, from the smallest source mip that still covers the working resolution
     bool ExtractGrayFromTexture(UTexture2D* Texture, FLoadedTexture& OutTexture);
 
-    float ComputeSSIM(const TArray<float>& A, const TArray<float>& B, int32 Width, int32 Height) const;
-    float ComputeMSSSIM(const TArray<float>& A, const TArray<float>& B, int32 Width, int32 Height) const;
+    // Halves the texture until it fits into MaxWorkingResolution
+    void ReduceToWorkingResolution(FLoadedTexture& Texture) const;
+    void BuildPyramid(const FLoadedTexture& Texture, FLuminancePyramid& OutPyramid) const;
+
+    // Pyramid of the asset from the feature store, decoding the texture only if no pyramid was built for it in this run
+    FLuminancePyramidPtr FindOrBuildPyramid(const FAssetData& Asset) const;
+
+    FName GetCachedGrayName() const;
+
+    // Whether MS-SSIM is defined for the pair: equal source resolutions, or equal comparison resolutions with bMatchAcrossResolutions
+    bool CanCompare(const FLuminancePyramid& A, const FLuminancePyramid& B) const;
+
+    // Resolution every texture with this aspect ratio is resampled to when bMatchAcrossResolutions is set
+    void GetComparisonSize(int32 SourceWidth, int32 SourceHeight, int32& OutWidth, int32& OutHeight) const;
+
+    float ComputeSSIM(const TArray<uint16>& A, const TArray<uint16>& B, int32 Width, int32 Height, TextureSSIMDeduplication::FSSIMScratch& Scratch) const;
+    float ComputeMSSSIM(const FLuminancePyramid& A, const FLuminancePyramid& B) const;
+
+    // Scratch buffers are pooled for the run instead of per thread, so they are freed with the pyramids once the run ends
+    TSharedPtr<TextureSSIMDeduplication::FSSIMScratch, ESPMode::ThreadSafe> AcquireScratch() const;
+    void ReleaseScratch(TSharedPtr<TextureSSIMDeduplication::FSSIMScratch, ESPMode::ThreadSafe> Scratch) const;
 
     void BuildGaussianKernel(int32 Radius, TArray<float>& OutKernel) const;
     void SeparableGaussianBlur(const TArray<float>& In, TArray<float>& Out, int32 Width, int32 Height, const TArray<float>& Kernel) const;
@@ -56,4 +102,33 @@ protected:
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Deduplication")
     int32 MSSSIMLevels = 5;
+
+    // Averages SSIM statistics over a (2 * GaussianRadius + 1)^2 box instead of a Gaussian window.
+    // The box sums come from integral images, so the cost does not depend on the radius; scores differ slightly from the Gaussian window
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Deduplication")
+    bool bUseBoxWindow = false;
+
+    // Only pairs whose perceptual hashes differ in at most PerceptualHashRadius bits are compared with MS-SSIM
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Deduplication")
+    bool bUsePerceptualHashPrefilter = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Deduplication", meta = (ClampMin = "0", ClampMax = "64", EditCondition = "bUsePerceptualHashPrefilter"))
+    int32 PerceptualHashRadius = 10;
+
+    // Resamples every texture to a resolution that only depends on its aspect ratio, so e.g. a 4K texture and its 2K re-import are compared
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Deduplication")
+    bool bMatchAcrossResolutions = false;
+
+    // Textures are compared at most at this resolution, larger ones are box-filtered down by powers of two
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Deduplication", meta = (ClampMin = "16", ClampMax = "4096"))
+    int32 MaxWorkingResolution = 256;
+
+private:
+    // Feature store of the current run, keyed by object path
+    mutable FCriticalSection PyramidsLock;
+    mutable TMap<FSoftObjectPath, FLuminancePyramidPtr> Pyramids;
+
+    // Idle scratch buffers of ComputeSSIM, one per concurrently compared pair at most
+    mutable FCriticalSection ScratchLock;
+    mutable TArray<TSharedPtr<TextureSSIMDeduplication::FSSIMScratch, ESPMode::ThreadSafe>> IdleScratches;
 };
@@ -0,0 +1,139 @@
+/*
+ * Publisher: AO
+ * Year of Publication: 2026
+ * Copyright AO All Rights Reserved.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "Containers/List.h"
+#include "Templates/Function.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+namespace UE
+{
+	class FManualResetEvent;
+}
+
+//Bytes of one asset, either owned on the heap or a read-only memory mapping of a file.
+class DEDUPLICATEPLUGIN_API FDeduplicationAssetBuffer
+{
+public:
+	explicit FDeduplicationAssetBuffer(TArray<uint8>&& InData);
+	FDeduplicationAssetBuffer(TUniquePtr<IMappedFileHandle>&& InMappedFile, TUniquePtr<IMappedFileRegion>&& InMappedRegion);
+	//View of [Offset, Offset + Size) of another buffer, which is kept alive by this one.
+	FDeduplicationAssetBuffer(TSharedPtr<const FDeduplicationAssetBuffer, ESPMode::ThreadSafe> InParent, int32 Offset, int32 InSize);
+	~FDeduplicationAssetBuffer();
+
+	FDeduplicationAssetBuffer(const FDeduplicationAssetBuffer&) = delete;
+	FDeduplicationAssetBuffer& operator=(const FDeduplicationAssetBuffer&) = delete;
+
+	//Maps the whole file. Returns null if the file can not be mapped, for example because it is empty.
+	static TSharedPtr<const FDeduplicationAssetBuffer, ESPMode::ThreadSafe> MapFile(const FString& Filename);
+
+	//Maps the file or reads it into memory if mapping is not possible.
+	static TSharedPtr<const FDeduplicationAssetBuffer, ESPMode::ThreadSafe> ReadFile(const FString& Filename, bool bAllowMapping);
+
+	TArrayView<const uint8> GetView() const
+	{
+		return TArrayView<const uint8>(Data, Size);
+	}
+
+	const uint8* GetData() const
+	{
+		return Data;
+	}
+
+	int32 Num() const
+	{
+		return Size;
+	}
+
+	bool IsMapped() const
+	{
+		return MappedRegion.IsValid() || (Parent.IsValid() && Parent->IsMapped());
+	}
+
+private:
+	TSharedPtr<const FDeduplicationAssetBuffer, ESPMode::ThreadSafe> Parent;
+	TArray<uint8> OwnedData;
+	//Declared before the region, so the region is unmapped before the file is closed.
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	const uint8* Data = nullptr;
+	int32 Size = 0;
+};
+
+using FDeduplicationAssetBytes = TSharedPtr<const FDeduplicationAssetBuffer, ESPMode::ThreadSafe>;
+
+//Per-run store of raw asset bytes. Every asset is read or serialized at most once per run, so pairwise comparisons work on buffers in memory.
+//Heap buffers are kept under a memory budget: when it is exceeded the least recently used buffers are spilled to a temporary file
+//and mapped back from there on the next access, which is much cheaper than serializing the asset again.
+//Memory mapped buffers are backed by the OS page cache, so they do not count against the budget. Each one holds an open file handle though,
+//so only a limited number of them are kept, least recently used mappings above that count are closed and mapped again on the next access.
+//Buffers handed out stay valid while the caller holds them, even if the store evicts them in the meantime.
+//Loads are single-flight: while one worker loads an asset, other workers requesting it wait for that load instead of starting their own.
+class DEDUPLICATEPLUGIN_API FDeduplicationAssetByteStore
+{
+public:
+	FDeduplicationAssetByteStore(int64 InMemoryBudgetBytes, bool bInSpillToDisk, int32 InMaxLiveMappings);
+	~FDeduplicationAssetByteStore();
+
+	FDeduplicationAssetByteStore(const FDeduplicationAssetByteStore&) = delete;
+	FDeduplicationAssetByteStore& operator=(const FDeduplicationAssetByteStore&) = delete;
+
+	//Returns the bytes of the asset, calling Loader only the first time the asset is requested. Returns null if loading failed.
+	//Loader is never called for the same asset on two threads at once. When spilling is enabled it is also not called again
+	//after eviction: buffers that can not be spilled stay in memory above the budget, and a spill file that can not be read back
+	//fails the asset instead of loading it again.
+	FDeduplicationAssetBytes GetAssetBytes(const FAssetData& Asset, TFunctionRef<FDeduplicationAssetBytes()> Loader);
+
+	//Stops calling loaders. Assets that were not loaded before are reported as failed. Used once every buffer that may be
+	//needed was loaded on the thread that is allowed to do so.
+	void Seal();
+
+	//Drops every buffer and deletes the spill files.
+	void Reset();
+
+	int64 GetResidentBytes() const;
+
+private:
+	struct FEntry
+	{
+		FDeduplicationAssetBytes Data;
+		FString SpillFilePath;
+		int64 Size = 0;
+		bool bLoadFailed = false;
+		//Set while a worker is loading the asset, signaled when the load finished.
+		TSharedPtr<UE::FManualResetEvent, ESPMode::ThreadSafe> PendingLoad;
+		TDoubleLinkedList<FSoftObjectPath>::TDoubleLinkedListNode* LruNode = nullptr;
+	};
+
+	FDeduplicationAssetBytes FindResident(const FSoftObjectPath& AssetPath, bool& bOutKnownFailure, FString& OutSpillFilePath, TSharedPtr<UE::FManualResetEvent, ESPMode::ThreadSafe>& OutPendingLoad);
+
+	void Touch(FEntry& Entry, const FSoftObjectPath& AssetPath);
+
+	void EvictToBudget(const FSoftObjectPath& KeepAssetPath);
+
+	void EvictMappings(const FSoftObjectPath& KeepAssetPath);
+
+	FString GetSpillDirectory() const;
+
+	mutable FCriticalSection StoreLock;
+	TMap<FSoftObjectPath, FEntry> Entries;
+	//Resident heap buffers, most recently used at the head.
+	TDoubleLinkedList<FSoftObjectPath> LruList;
+	//Resident mapped buffers, most recently used at the head.
+	TDoubleLinkedList<FSoftObjectPath> MappedLruList;
+	int64 ResidentBytes = 0;
+	int64 MemoryBudgetBytes = 0;
+	int32 MaxLiveMappings = 0;
+	int32 NextSpillFileIndex = 0;
+	bool bSpillToDisk = true;
+	bool bSealed = false;
+	FGuid StoreId;
+};
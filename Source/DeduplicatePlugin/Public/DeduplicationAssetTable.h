@@ -0,0 +1,57 @@
+/*
+ * Publisher: AO
+ * Year of Publication: 2026
+ * Copyright AO All Rights Reserved.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+
+struct FDuplicateGroup;
+
+//Analysis-scoped table that stores every analyzed FAssetData once and identifies it by a dense int32 ID.
+//The manager interns all assets before any DeduplicateObject starts, after that the table is read-only and can be used from any thread.
+//The manager's stored groups keep only IDs while the analysis runs, FAssetData is materialized again for the clusters shown in the UI and saved results.
+class DEDUPLICATEPLUGIN_API FDeduplicationAssetTable
+{
+public:
+	//Must not be called while DeduplicateObjects are running.
+	void Reset();
+
+	//Returns the ID of the asset, adding it if needed. Must not be called while DeduplicateObjects are running.
+	int32 Intern(const FAssetData& Asset);
+
+	//Returns the ID of the asset or INDEX_NONE if it was not interned.
+	int32 Find(const FAssetData& Asset) const;
+
+	const FAssetData& GetAsset(int32 AssetId) const
+	{
+		return Assets[AssetId];
+	}
+
+	bool IsValidId(int32 AssetId) const
+	{
+		return Assets.IsValidIndex(AssetId);
+	}
+
+	int32 Num() const
+	{
+		return Assets.Num();
+	}
+
+	//Replaces the FAssetData of the group with IDs. Groups containing assets that are not in the table are left untouched.
+	//Only for groups owned by the manager, never for groups that are broadcast.
+	void CompactGroup(FDuplicateGroup& Group) const;
+
+	//Returns the assets of the group whether it is compacted or not.
+	void GetGroupAssets(const FDuplicateGroup& Group, TArray<FAssetData>& OutAssets) const;
+
+	//Returns the IDs of the group, interning assets of groups that were not compacted. Must not be called while DeduplicateObjects are running.
+	void GetGroupAssetIds(const FDuplicateGroup& Group, TArray<int32>& OutAssetIds);
+
+private:
+	TArray<FAssetData> Assets;
+	TMap<FSoftObjectPath, int32> IdsByPath;
+};
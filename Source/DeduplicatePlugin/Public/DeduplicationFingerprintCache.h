@@ -0,0 +1,168 @@
+/*
+ * Publisher: AO
+ * Year of Publication: 2026
+ * Copyright AO All Rights Reserved.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "IO/IoHash.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+//Identifies the exact saved state of a package. Derived features stay valid while the key is unchanged.
+struct DEDUPLICATEPLUGIN_API FDeduplicationFingerprintKey
+{
+	FIoHash PackageSavedHash;
+	int64 DiskSize = -1;
+	FDateTime TimeStamp;
+
+	bool operator==(const FDeduplicationFingerprintKey& Other) const
+	{
+		return PackageSavedHash == Other.PackageSavedHash
+			&& DiskSize == Other.DiskSize
+			&& TimeStamp == Other.TimeStamp;
+	}
+
+	bool operator!=(const FDeduplicationFingerprintKey& Other) const
+	{
+		return !(*this == Other);
+	}
+
+	friend FArchive& operator<<(FArchive& Ar, FDeduplicationFingerprintKey& Key)
+	{
+		Ar << Key.PackageSavedHash;
+		Ar << Key.DiskSize;
+		Ar << Key.TimeStamp;
+		return Ar;
+	}
+};
+
+struct DEDUPLICATEPLUGIN_API FDeduplicationFingerprintEntry
+{
+	FDeduplicationFingerprintKey Key;
+	TMap<FName, TArray<uint8>> Features;
+
+	friend FArchive& operator<<(FArchive& Ar, FDeduplicationFingerprintEntry& Entry)
+	{
+		Ar << Entry.Key;
+		Ar << Entry.Features;
+		return Ar;
+	}
+};
+
+//What the saved state of a cached feature depends on.
+enum class EDeduplicationFingerprintScope : uint8
+{
+	//Only the package of the asset itself.
+	Package,
+	//The package and every class it derives from. Used by features read through reflection, class defaults or graphs,
+	//which change when a parent blueprint is saved or a native class layout changes.
+	ClassHierarchy,
+};
+
+//Persistent on-disk cache of per-asset derived features (raw bytes digests, block hashes, gray thumbnails, graph signatures, reflection fingerprints).
+//Entries are keyed by package name and are dropped as soon as the package saved hash, disk size or timestamp reported by the Asset Registry changes,
+//so DeduplicateObjects can skip loading and serializing unchanged assets on subsequent runs.
+//Packages are spread over shard files by a hash of their name. Shards are read when a package in them is first looked up, only changed shards are
+//written back, and entries of packages that no longer exist are dropped when their shard is read.
+//Feature names are chosen by each DeduplicateObject and must encode every setting that changes the derived data.
+class DEDUPLICATEPLUGIN_API FDeduplicationFingerprintCache
+{
+public:
+	static FDeduplicationFingerprintCache& Get();
+
+	bool FindFeature(const FAssetData& Asset, FName FeatureName, TArray<uint8>& OutPayload, EDeduplicationFingerprintScope Scope = EDeduplicationFingerprintScope::Package);
+
+	void StoreFeature(const FAssetData& Asset, FName FeatureName, TArray<uint8>&& Payload, EDeduplicationFingerprintScope Scope = EDeduplicationFingerprintScope::Package);
+
+	bool HasFeature(const FAssetData& Asset, FName FeatureName, EDeduplicationFingerprintScope Scope = EDeduplicationFingerprintScope::Package);
+
+	template<typename FeatureType>
+	bool FindFeature(const FAssetData& Asset, FName FeatureName, FeatureType& OutFeature, EDeduplicationFingerprintScope Scope = EDeduplicationFingerprintScope::Package)
+	{
+		TArray<uint8> Payload;
+		if (!FindFeature(Asset, FeatureName, Payload, Scope))
+		{
+			return false;
+		}
+
+		FMemoryReader Reader(Payload, /*bIsPersistent=*/ true);
+		Reader << OutFeature;
+		return !Reader.IsError();
+	}
+
+	template<typename FeatureType>
+	void StoreFeature(const FAssetData& Asset, FName FeatureName, FeatureType& Feature, EDeduplicationFingerprintScope Scope = EDeduplicationFingerprintScope::Package)
+	{
+		TArray<uint8> Payload;
+		FMemoryWriter Writer(Payload, /*bIsPersistent=*/ true);
+		Writer << Feature;
+		StoreFeature(Asset, FeatureName, MoveTemp(Payload), Scope);
+	}
+
+	//Writes the shards that changed since the last flush, and the shard index.
+	void Flush();
+
+	//Drops all cached features both in memory and on disk.
+	void Clear();
+
+	//Forgets the package keys and class hierarchy hashes computed so far. Called when an analysis starts, so packages saved since the last run
+	//are fingerprinted again.
+	void ResetFingerprintKeys();
+
+private:
+	//Returns the key of the package, querying the file system and the Asset Registry only the first time the package is seen in a run.
+	bool GetFingerprintKey(const FAssetData& Asset, FDeduplicationFingerprintKey& OutKey);
+
+	static bool ComputeFingerprintKey(const FAssetData& Asset, FDeduplicationFingerprintKey& OutKey);
+
+	//Returns a hash of the saved state of every class the asset derives from, computed once per package per run.
+	FIoHash GetClassHierarchyHash(const FAssetData& Asset);
+
+	FIoHash ComputeClassHierarchyHash(const FAssetData& Asset);
+
+	//Hashes the property layout and default values of a native class, computed once per class per run.
+	FIoHash GetNativeClassHash(const FString& ClassPath);
+
+	//Payloads of ClassHierarchy features start with the class hierarchy hash they were built against. Returns the hash to expect, if any.
+	TOptional<FIoHash> GetScopeHash(const FAssetData& Asset, EDeduplicationFingerprintScope Scope);
+
+	static constexpr int32 NumShards = 256;
+
+	struct FShard
+	{
+		TMap<FName, FDeduplicationFingerprintEntry> Entries;
+		bool bLoaded = false;
+		bool bDirty = false;
+	};
+
+	//Shard of the package, read from disk on first use. Must be called under CacheLock.
+	FShard& GetShard(FName PackageName);
+
+	void LoadShard(int32 ShardIndex, FShard& Shard);
+
+	void LoadIndexIfNeeded();
+
+	static int32 GetShardIndex(FName PackageName);
+
+	static FString GetCacheDirectory();
+
+	static FString GetShardFilePath(int32 ShardIndex);
+
+	static FString GetIndexFilePath();
+
+	FCriticalSection CacheLock;
+	FShard Shards[NumShards];
+	//Number of entries in every shard file as of the last flush, INDEX_NONE where unknown. Shards without entries are never read.
+	TArray<int32> ShardEntryCounts;
+	bool bIndexLoaded = false;
+	//Keys of the packages seen in the current run, unset for packages without a key.
+	TMap<FName, TOptional<FDeduplicationFingerprintKey>> RunKeys;
+	//Class hierarchy hashes of the packages seen in the current run.
+	TMap<FName, FIoHash> RunHierarchyHashes;
+	//Layout hashes of the native classes seen in the current run, keyed by class path.
+	TMap<FString, FIoHash> RunNativeClassHashes;
+};
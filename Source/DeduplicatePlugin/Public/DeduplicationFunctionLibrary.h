@@ -23,8 +23,13 @@ public:
 
 	static TArray<FAssetData> FilterRedirects(const TArray<FAssetData>& Assets);
 
-	static int32 FindCommonSubstrings(const TArray<uint8>& Data1, const TArray<uint8>& Data2, int32 MinLength);
+	//Number of offsets in Data1 whose MinLength bytes occur anywhere in Data2. Linear in the size of both buffers.
+	static int32 FindCommonSubstrings(TArrayView<const uint8> Data1, TArrayView<const uint8> Data2, int32 MinLength);
 	
 	static int ComputeLevenshteinDistance(const FString& Str1, const FString& Str2);
 
+	//Returns the Levenshtein distance if it is at most MaxDistance, otherwise MaxDistance + 1, stopping as soon as the bound can not be met.
+	//Names of up to 64 characters are compared without any heap allocation.
+	static int32 ComputeLevenshteinDistanceBounded(const FString& Str1, const FString& Str2, int32 MaxDistance);
+
 };
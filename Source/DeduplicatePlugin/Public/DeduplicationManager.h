@@ -9,6 +9,7 @@
 #include "CoreMinimal.h"
 #include "UObject/Object.h"
 #include "DeduplicateObjects/DeduplicateObject.h"
+#include "DeduplicationAssetTable.h"
 #include "DeduplicationManager.generated.h"
 
 
@@ -148,6 +149,9 @@ public:
 	TArray<FDuplicateGroup> DeduplicateGroups;
 	TArray<FDuplicateGroup> EarlyDeduplicateGroups;
 
+	//Every asset of the current analysis, interned once. Groups refer to assets by their IDs in this table.
+	FDeduplicationAssetTable AssetTable;
+
 	void StartAnalyzeAssetsAsync(const TArray<FAssetData>& AssetsToAnalyze);
 
 	void StartDeduplicationAsyncAfterEarlyCheck();
@@ -179,6 +183,14 @@ public:
 	//Specifies the method by which group proximity scores will be summed.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings")
 	ECombinationScoreMethod CombinationScoreMethod;
+
+	//Maximum number of helper tasks that DeduplicateObjects may use together for pairwise comparisons. 0 uses every task graph worker thread.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings", meta = (ClampMin = "0"))
+	int32 MaxConcurrentTasks = 0;
+
+	//Pairwise comparisons are split into tiles of PairwiseTileSize x PairwiseTileSize assets that are distributed between the tasks.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Settings", meta = (ClampMin = "1"))
+	int32 PairwiseTileSize = 64;
 	
 	float CompleteProgress = 0;
 	float SummaryComplexity = 0;
@@ -0,0 +1,25 @@
+/*
+ * Publisher: AO
+ * Year of Publication: 2026
+ * Copyright AO All Rights Reserved.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+//Package-aware view of raw .uasset bytes for the binary comparers.
+//The package summary, name map, import and export tables embed the path and name of the asset, so two copies of the same asset in
+//different folders differ mostly there. Comparing only the serialized exports and their payloads ignores those tables.
+class DEDUPLICATEPLUGIN_API FDeduplicationPackageBytes
+{
+public:
+	//Finds the serialized exports: everything after the package header up to the end of the file, including inline bulk data.
+	//Returns false if the bytes are not a package.
+	static bool FindExportRegion(TArrayView<const uint8> PackageBytes, int64& OutOffset, int64& OutSize);
+
+	//Copies the export region and replaces the name map index of every FName in the tagged property headers of each export, and in
+	//name property values, with its index in the sorted name map. Packages whose name maps hold the same names in a different order
+	//then compare equal. Exports whose tags cannot be parsed are copied unchanged. Returns false if the bytes are not a package.
+	static bool ExtractNormalizedExports(TArrayView<const uint8> PackageBytes, TArray<uint8>& OutBytes);
+};
@@ -0,0 +1,62 @@
+/*
+ * Publisher: AO
+ * Year of Publication: 2026
+ * Copyright AO All Rights Reserved.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+
+//Widest vector instruction set the kernels use on this CPU, chosen once at runtime.
+enum class EDeduplicationInstructionSet : uint8
+{
+	Scalar,
+	SSE2,
+	AVX2,
+	NEON
+};
+
+//Scoring of the affine gap (Gotoh) global alignment used by UEqualNeedlemanWunschDataDeduplication.
+//Only cells with Row - BandBelow <= Column <= Row + BandAbove are evaluated.
+struct FDeduplicationGotohScoring
+{
+	int32 MatchScore = 2;
+	int32 MismatchScore = -1;
+	int32 GapOpen = -5;
+	int32 GapExtend = -1;
+	int32 BandBelow = MAX_int32;
+	int32 BandAbove = MAX_int32;
+};
+
+//Number of matching bytes and length of the optimal alignment path.
+struct FDeduplicationGotohPathStats
+{
+	int32 Matches = 0;
+	int32 Length = 0;
+};
+
+//Vectorized inner loops shared by DeduplicateObjects. Every kernel has a scalar equivalent in the calling algorithm and produces the same result.
+class DEDUPLICATEPLUGIN_API FDeduplicationSimdKernels
+{
+public:
+	static EDeduplicationInstructionSet GetInstructionSet();
+
+	static const TCHAR* GetInstructionSetName(EDeduplicationInstructionSet InstructionSet);
+
+	//Aligns A and B anti-diagonal by anti-diagonal, so the cells of a diagonal are independent and processed in vector lanes.
+	//Returns false if the CPU has no supported vector unit. When ShouldStop aborts the alignment OutStats stays empty.
+	static bool AlignGotoh(
+		TArrayView<const uint8> A,
+		TArrayView<const uint8> B,
+		const FDeduplicationGotohScoring& Scoring,
+		TFunctionRef<bool()> ShouldStop,
+		FDeduplicationGotohPathStats& OutStats);
+
+	//Number of positions in [0, Num) where A and B hold the same byte.
+	static int64 CountEqualBytes(const uint8* A, const uint8* B, int64 Num);
+
+	//Sum over [0, Num) of the SSIM map clamped to [0, 1], from the local means of A and B and the local means of A*A, B*B and A*B.
+	static double SumSSIM(const float* MuA, const float* MuB, const float* MuAA, const float* MuBB, const float* MuAB, int64 Num, float C1, float C2);
+};
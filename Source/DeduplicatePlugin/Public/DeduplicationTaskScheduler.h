@@ -0,0 +1,65 @@
+/*
+ * Publisher: AO
+ * Year of Publication: 2026
+ * Copyright AO All Rights Reserved.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+
+//Pair of item indices (IndexA < IndexB) whose similarity reached the threshold.
+struct FDeduplicationSimilarPair
+{
+	int32 IndexA = INDEX_NONE;
+	int32 IndexB = INDEX_NONE;
+	float Similarity = 0.0f;
+};
+
+//Runs the pairwise part of DeduplicateObjects on UE::Tasks.
+//The upper triangle of the NumItems x NumItems comparison matrix is split into square tiles. The calling thread and up to
+//MaxConcurrentTasks helper tasks pull tiles from a shared queue until it is empty, so one huge class group keeps every worker busy
+//instead of pinning a single thread. The helper limit is shared by all running DeduplicateObjects.
+class DEDUPLICATEPLUGIN_API FDeduplicationTaskScheduler
+{
+public:
+	//Returns every pair with Similarity(IndexA, IndexB) >= Threshold sorted by (IndexA, IndexB), so the result does not depend on scheduling.
+	//Similarity is called concurrently and must be thread safe. OnProgress receives [0..1] and is only called on the calling thread.
+	//MaxConcurrentTasks <= 0 means the number of task graph worker threads.
+	static TArray<FDeduplicationSimilarPair> FindSimilarPairs(
+		int32 NumItems,
+		float Threshold,
+		int32 TileSize,
+		int32 MaxConcurrentTasks,
+		TFunctionRef<float(int32, int32)> Similarity,
+		TFunctionRef<bool()> ShouldStop,
+		TFunctionRef<void(float)> OnProgress);
+
+	//Same as FindSimilarPairs, but only evaluates the given candidate pairs, for algorithms that can generate candidates cheaper than all pairs.
+	static TArray<FDeduplicationSimilarPair> FilterSimilarPairs(
+		TArrayView<const TPair<int32, int32>> CandidatePairs,
+		float Threshold,
+		int32 TileSize,
+		int32 MaxConcurrentTasks,
+		TFunctionRef<float(int32, int32)> Similarity,
+		TFunctionRef<bool()> ShouldStop,
+		TFunctionRef<void(float)> OnProgress);
+
+	//Runs Body for every item in [0, NumItems) on the calling thread and helper tasks, ChunkSize items at a time.
+	static void ParallelFor(
+		int32 NumItems,
+		int32 ChunkSize,
+		int32 MaxConcurrentTasks,
+		TFunctionRef<void(int32)> Body,
+		TFunctionRef<bool()> ShouldStop);
+
+private:
+	//Runs ProcessTile for tiles [0, NumTiles) on the calling thread and helper tasks and returns the collected pairs sorted by index.
+	static TArray<FDeduplicationSimilarPair> RunTiles(
+		int64 NumTiles,
+		int32 MaxConcurrentTasks,
+		TFunctionRef<void(int64, TArray<FDeduplicationSimilarPair>&)> ProcessTile,
+		TFunctionRef<bool()> ShouldStop,
+		TFunctionRef<void(float)> OnProgress);
+};